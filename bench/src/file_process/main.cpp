@@ -0,0 +1,148 @@
+/** \brief This file contains the benchmark for Output File Processing.
+ *
+ * A synthetic simulator log of the requested size is generated
+ * with the same structure as abp_output.txt. It is then processed
+ * by the single threaded and the multi threaded output_file_process
+ * and by the regular expression output_file_process_regex. The time
+ * taken by each and whether their outputs are identical is printed.
+ *
+ * Usage: ./FILE_PROCESS_BENCH [size in MB] [path of the generated log]
+*/
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../../../include/file_process.hpp"
+
+#define BENCH_DEFAULT_SIZE_MB 4096
+#define BENCH_LOG_PATH "synthetic_abp_output.txt"
+#define BENCH_STREAM_PATH "synthetic_abp_proc_stream.txt"
+#define BENCH_PARALLEL_PATH "synthetic_abp_proc_parallel.txt"
+#define BENCH_REGEX_PATH "synthetic_abp_proc_regex.txt"
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+
+/**
+ * Function that writes a log made of repeated blocks of the
+ * simulator output until the file reaches the given size.
+ * @param path log file name string
+ * @param size size of the log in bytes
+*/
+static void generate_log(const char *path, unsigned long long size) {
+    static const char *block[] = {
+        "[iestream_input_defs<Message_t>::out: {20}] generated by model generator_con",
+        "[sender_defs::packet_sent_out: {1}, sender_defs::ack_received_out: {}, sender_defs::data_out: {11}] generated by model sender1",
+        "[] generated by model receiver1",
+        "[subnet_defs::out: {11}] generated by model subnet1",
+        "[] generated by model subnet2",
+        "[repeater_defs::packet_sent_out: {11}, repeater_defs::ack_received_out: {}] generated by model repeater1",
+        "[] generated by model subnet3",
+        "[] generated by model subnet4"
+    };
+    ofstream out(path);
+    string buf;
+    unsigned long long written = 0;
+    unsigned long long ms = 0;
+    char time[32];
+
+    while (written < size) {
+        buf.clear();
+        for (int t = 0; t < 1024; t++) {
+            ms += 1000;
+            snprintf(time, sizeof(time), "%02llu:%02llu:%02llu:%03llu\n",
+                     ms / 3600000, ms / 60000 % 60, ms / 1000 % 60, ms % 1000);
+            buf += time;
+            for (const char *line : block) {
+                buf += line;
+                buf += '\n';
+            }
+        }
+        out.write(buf.data(), buf.size());
+        written += buf.size();
+    }
+}
+
+/**
+ * Function that compares two files byte by byte.
+ * @return true if the files are identical
+*/
+static bool same_files(const char *a, const char *b) {
+    ifstream fa(a, ios::binary);
+    ifstream fb(b, ios::binary);
+    string ba(1 << 20, '\0');
+    string bb(1 << 20, '\0');
+    while (fa && fb) {
+        fa.read(&ba[0], ba.size());
+        fb.read(&bb[0], bb.size());
+        if (fa.gcount() != fb.gcount() ||
+            ba.compare(0, fa.gcount(), bb, 0, fb.gcount()) != 0) {
+            return false;
+        }
+    }
+    return fa.eof() && fb.eof();
+}
+
+static double seconds_since(hclock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::duration<double,
+        std::ratio<1>>>(hclock::now() - start).count();
+}
+
+int main(int argc, char ** argv) {
+    unsigned long long size_mb = BENCH_DEFAULT_SIZE_MB;
+    char log_file[] = BENCH_LOG_PATH;
+    char stream_file[] = BENCH_STREAM_PATH;
+    char parallel_file[] = BENCH_PARALLEL_PATH;
+    char regex_file[] = BENCH_REGEX_PATH;
+    char *in_file = log_file;
+
+    if (argc > 1) {
+        size_mb = strtoull(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        in_file = argv[2];
+    }
+
+    cout << "Generating " << size_mb << " MB log" << endl;
+    auto start = hclock::now();
+    generate_log(in_file, size_mb << 20);
+    cout << "Log generated. Elapsed time: " << seconds_since(start)
+         << "sec" << endl;
+
+    start = hclock::now();
+    output_file_process(in_file, stream_file);
+    double stream_time = seconds_since(start);
+    cout << "Streaming: " << stream_time << "sec, "
+         << size_mb / stream_time << " MB/sec" << endl;
+
+    start = hclock::now();
+    output_file_process(in_file, parallel_file, 0);
+    double parallel_time = seconds_since(start);
+    cout << "Parallel:  " << parallel_time << "sec, "
+         << size_mb / parallel_time << " MB/sec" << endl;
+
+    start = hclock::now();
+    output_file_process_regex(in_file, regex_file);
+    double regex_time = seconds_since(start);
+    cout << "Regex:     " << regex_time << "sec, "
+         << size_mb / regex_time << " MB/sec" << endl;
+
+    cout << "Speedup:   " << regex_time / stream_time << "x" << endl;
+    if (!same_files(stream_file, regex_file) ||
+        !same_files(parallel_file, regex_file)) {
+        cout << "Outputs differ" << endl;
+        return 1;
+    }
+    cout << "Outputs identical" << endl;
+
+    remove(in_file);
+    remove(stream_file);
+    remove(parallel_file);
+    remove(regex_file);
+    return 0;
+}
@@ -0,0 +1,397 @@
+/** \brief This file contains the microbenchmarks of the atomic models.
+ *
+ * Every atomic model is benchmarked with Google Benchmark, one
+ * benchmark per function the runner calls: external_transition,
+ * internal_transition, confluence_transition, output and
+ * time_advance. A model with inputs is benchmarked from two states,
+ * idle as an input finds it and busy after the input:
+ * external_transition from idle, the others from busy. The
+ * transitions are timed in batches of BENCH_BATCH calls, one per copy
+ * of the model; the copies are set back to the state with the timing
+ * paused before every batch, so every call starts from the same state
+ * and the copy is not timed. The message bags are passed by value as
+ * the runner passes them. The sources, the traffic generator and the generator
+ * of an input file, are stepped by internal_transition through
+ * their events.
+ *
+ * Parser::next_timed_input is benchmarked on a generated input file
+ * of BENCH_INPUT_LINES lines, as text and compiled by EVENT_COMPILE,
+ * and write_file on a generated simulator log, with the regular
+ * expressions of output_file_process_regex and with the log view of
+ * output_file_process.
+ *
+ * The generated files are written to the current folder and removed
+ * at the end. The arguments are those of Google Benchmark, as
+ * --benchmark_filter=Subnet.
+ *
+ * Usage: ./MICRO_BENCH [--benchmark_filter=REGEX] [--benchmark_format=json]
+*/
+
+#include <iostream>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <cadmium/modeling/message_bag.hpp>
+
+#include "../../../lib/DESTimes/include/NDTime.hpp"
+#include "../../../lib/iestream.hpp"
+
+#include "../../../include/message.hpp"
+#include "../../../include/sender_cadmium.hpp"
+#include "../../../include/receiver_cadmium.hpp"
+#include "../../../include/subnet_cadmium.hpp"
+#include "../../../include/repeater_cadmium.hpp"
+#include "../../../include/buffered_repeater_cadmium.hpp"
+#include "../../../include/link_cadmium.hpp"
+#include "../../../include/window_sender_cadmium.hpp"
+#include "../../../include/window_receiver_cadmium.hpp"
+#include "../../../include/traffic_generator_cadmium.hpp"
+#include "../../../include/file_process.hpp"
+#include "../../../include/log_view.hpp"
+#include "../../../include/timed_events.hpp"
+
+#define BENCH_ELAPSED "00:00:01:000"
+#define BENCH_INPUT_LINES 65536
+#define BENCH_BATCH 256
+#define BENCH_LOG_STEPS 256
+#define BENCH_INPUT_PATH "micro_bench_input.txt"
+#define BENCH_EVENTS_PATH "micro_bench_input.evt"
+#define BENCH_OUTPUT_PATH "/dev/null"
+
+using namespace std;
+
+using TIME = NDTime;
+
+template<typename MODEL>
+using input_bags =
+    typename cadmium::make_message_bags<typename MODEL::input_ports>::type;
+
+/**
+ * Generator of an input file, as ApplicationGen of ABP.
+*/
+template<typename T>
+class ApplicationGen : public iestream_input<Message_t,T> {
+public:
+    ApplicationGen() = default;
+    ApplicationGen(const char* file_path) :
+        iestream_input<Message_t,T>(file_path) {}
+};
+
+/**
+ * Function that returns the bags of one message on a port.
+*/
+template<typename MODEL, typename PORT>
+static input_bags<MODEL> bags_of(const Message_t &message) {
+    input_bags<MODEL> bags;
+    cadmium::get_messages<PORT>(bags).push_back(message);
+    return bags;
+}
+
+/**
+ * Function that times a transition of a model from a state in
+ * batches of BENCH_BATCH copies of the model, which are set to the
+ * state with the timing paused.
+ * @param st benchmark state
+ * @param from model in the state
+ * @param transition function that runs the transition of a model
+*/
+template<typename MODEL, typename TRANSITION>
+static void time_transition(benchmark::State &st, const MODEL &from,
+                            TRANSITION transition) {
+    vector<MODEL> models(BENCH_BATCH, from);
+    while (st.KeepRunningBatch(BENCH_BATCH)) {
+        st.PauseTiming();
+        for (MODEL &model : models) {
+            model.state = from.state;
+        }
+        st.ResumeTiming();
+        for (MODEL &model : models) {
+            transition(model);
+            benchmark::DoNotOptimize(model.state);
+        }
+    }
+}
+
+/**
+ * Function that registers the external transition of a model
+ * from a state.
+ * @param name benchmark name
+ * @param idle model in the state the input finds it
+ * @param input message bags of the input
+*/
+template<typename MODEL>
+static void add_external(const string &name, const MODEL &idle,
+                         const input_bags<MODEL> &input) {
+    benchmark::RegisterBenchmark(name.c_str(),
+        [idle, input](benchmark::State &st) {
+            TIME e(BENCH_ELAPSED);
+            time_transition(st, idle, [&](MODEL &model) {
+                model.external_transition(e, input);
+            });
+        });
+}
+
+/**
+ * Function that registers the benchmarks of a model with inputs.
+ * The busy state is that of the idle model after the input.
+ * @param name model name
+ * @param idle model in the state the input finds it
+ * @param input message bags of the input
+*/
+template<typename MODEL>
+static void add_transitions(const string &name, const MODEL &idle,
+                            const input_bags<MODEL> &input) {
+    MODEL busy = idle;
+    busy.external_transition(TIME(BENCH_ELAPSED), input);
+
+    add_external(name + "/external_transition", idle, input);
+    benchmark::RegisterBenchmark((name + "/internal_transition").c_str(),
+        [busy](benchmark::State &st) {
+            time_transition(st, busy, [](MODEL &model) {
+                model.internal_transition();
+            });
+        });
+    benchmark::RegisterBenchmark((name + "/confluence_transition").c_str(),
+        [busy, input](benchmark::State &st) {
+            TIME e(BENCH_ELAPSED);
+            time_transition(st, busy, [&](MODEL &model) {
+                model.confluence_transition(e, input);
+            });
+        });
+    benchmark::RegisterBenchmark((name + "/output").c_str(),
+        [busy](benchmark::State &st) {
+            for (auto _ : st) {
+                benchmark::DoNotOptimize(busy.output());
+            }
+        });
+    benchmark::RegisterBenchmark((name + "/time_advance").c_str(),
+        [busy](benchmark::State &st) {
+            for (auto _ : st) {
+                benchmark::DoNotOptimize(busy.time_advance());
+            }
+        });
+}
+
+/**
+ * Function that registers the benchmarks of the traffic generator,
+ * which is stepped through its arrivals.
+*/
+static void add_traffic_generator(const traffic_spec &spec) {
+    benchmark::RegisterBenchmark("TrafficGenerator/internal_transition",
+        [spec](benchmark::State &st) {
+            TrafficGenerator<TIME> model(spec);
+            for (auto _ : st) {
+                model.internal_transition();
+                benchmark::DoNotOptimize(model.state);
+            }
+        });
+    TrafficGenerator<TIME> model(spec);
+    model.internal_transition();
+    benchmark::RegisterBenchmark("TrafficGenerator/output",
+        [model](benchmark::State &st) {
+            for (auto _ : st) {
+                benchmark::DoNotOptimize(model.output());
+            }
+        });
+    benchmark::RegisterBenchmark("TrafficGenerator/time_advance",
+        [model](benchmark::State &st) {
+            for (auto _ : st) {
+                benchmark::DoNotOptimize(model.time_advance());
+            }
+        });
+}
+
+/**
+ * Function that registers the benchmarks of the generator of an input
+ * file. Its state holds the parser, which can not be copied, so it is
+ * stepped through the file and built again at the end.
+*/
+static void add_file_generator() {
+    benchmark::RegisterBenchmark("ApplicationGen/internal_transition",
+        [](benchmark::State &st) {
+            unique_ptr<ApplicationGen<TIME>> model(
+                new ApplicationGen<TIME>(BENCH_INPUT_PATH));
+            for (auto _ : st) {
+                if (model->state._input_ended &&
+                    model->state._next_input.empty()) {
+                    st.PauseTiming();
+                    model.reset(new ApplicationGen<TIME>(BENCH_INPUT_PATH));
+                    st.ResumeTiming();
+                }
+                model->internal_transition();
+                benchmark::DoNotOptimize(model->state._next_input);
+            }
+        });
+    benchmark::RegisterBenchmark("ApplicationGen/output",
+        [](benchmark::State &st) {
+            ApplicationGen<TIME> model(BENCH_INPUT_PATH);
+            model.internal_transition();
+            for (auto _ : st) {
+                benchmark::DoNotOptimize(model.output());
+            }
+        });
+    benchmark::RegisterBenchmark("ApplicationGen/time_advance",
+        [](benchmark::State &st) {
+            ApplicationGen<TIME> model(BENCH_INPUT_PATH);
+            model.internal_transition();
+            for (auto _ : st) {
+                benchmark::DoNotOptimize(model.time_advance());
+            }
+        });
+}
+
+/**
+ * Function that registers the benchmark of Parser::next_timed_input
+ * on a file, which is opened again at its end.
+*/
+static void add_parser(const char *name, const char *path) {
+    benchmark::RegisterBenchmark(name, [path](benchmark::State &st) {
+        unique_ptr<Parser<TIME, Message_t>> parser(
+            new Parser<TIME, Message_t>(path));
+        pair<TIME, Message_t> input;
+        for (auto _ : st) {
+            if (parser->next_timed_input(input) != parse_status::ok) {
+                st.PauseTiming();
+                parser.reset(new Parser<TIME, Message_t>(path));
+                st.ResumeTiming();
+            }
+            benchmark::DoNotOptimize(input);
+        }
+    });
+}
+
+/**
+ * Function that registers the benchmarks of write_file on a log.
+*/
+static void add_write_file(const string &log) {
+    benchmark::RegisterBenchmark("write_file/regex",
+        [log](benchmark::State &st) {
+            vector<char> file(log.size() + 1);
+            char fout[] = BENCH_OUTPUT_PATH;
+            for (auto _ : st) {
+                st.PauseTiming();
+                memcpy(file.data(), log.c_str(), log.size() + 1);
+                st.ResumeTiming();
+                write_file(fout, file.data());
+            }
+            st.SetBytesProcessed(st.iterations() * log.size());
+        });
+    benchmark::RegisterBenchmark("write_file/log_view",
+        [log](benchmark::State &st) {
+            char fout[] = BENCH_OUTPUT_PATH;
+            for (auto _ : st) {
+                write_file(fout, log_view(log.data(), log.size()));
+            }
+            st.SetBytesProcessed(st.iterations() * log.size());
+        });
+}
+
+/**
+ * Function that writes an input file of increasing times.
+ * @return true if the file was written
+*/
+static bool generate_input(const char *path) {
+    ofstream out(path);
+    char line[64];
+    for (unsigned long long i = 1; i <= BENCH_INPUT_LINES; i++) {
+        unsigned long long ms = i * 1500;
+        snprintf(line, sizeof(line), "%02llu:%02llu:%02llu:%03llu %llu\n",
+                 ms / 3600000, ms / 60000 % 60, ms / 1000 % 60, ms % 1000,
+                 i % 9 + 1);
+        out << line;
+    }
+    return (bool) out;
+}
+
+/**
+ * Function that returns a simulator log with the structure
+ * of abp_output.txt.
+*/
+static string generate_log() {
+    static const char *block[] = {
+        "[iestream_input_defs<Message_t>::out: {20}] generated by model generator_con",
+        "[sender_defs::packet_sent_out: {1}, sender_defs::ack_received_out: {}, sender_defs::data_out: {11}] generated by model sender1",
+        "[] generated by model receiver1",
+        "[subnet_defs::out: {11}] generated by model subnet1",
+        "[] generated by model subnet2",
+        "[repeater_defs::packet_sent_out: {11}, repeater_defs::ack_received_out: {}] generated by model repeater1",
+        "[] generated by model subnet3",
+        "[] generated by model subnet4"
+    };
+    string log;
+    char time[32];
+    for (unsigned long long ms = 1000; ms <= BENCH_LOG_STEPS * 1000ULL;
+         ms += 1000) {
+        snprintf(time, sizeof(time), "%02llu:%02llu:%02llu:%03llu\n",
+                 ms / 3600000, ms / 60000 % 60, ms / 1000 % 60, ms % 1000);
+        log += time;
+        for (const char *line : block) {
+            log += line;
+            log += '\n';
+        }
+    }
+    return log;
+}
+
+int main(int argc, char ** argv) {
+    char input_path[] = BENCH_INPUT_PATH;
+    char events_path[] = BENCH_EVENTS_PATH;
+    if (!generate_input(input_path) ||
+        compile_timed_events(input_path, events_path) < 0) {
+        cout << "The input files of the benchmark can not be written, errno = "
+             << errno << "\n";
+        return 1;
+    }
+
+    Message_t control = Message_t::number(5);
+    Message_t packet = Message_t::data(1, 1);
+
+    Sender<TIME> sender;
+    add_transitions(string("Sender"), sender,
+                    bags_of<Sender<TIME>, sender_defs::control_in>(control));
+    sender.external_transition(TIME(BENCH_ELAPSED),
+        bags_of<Sender<TIME>, sender_defs::control_in>(control));
+    sender.internal_transition();
+    add_external(string("Sender/external_transition/ack"), sender,
+                 bags_of<Sender<TIME>, sender_defs::ack_in>(
+                     Message_t::ack(1)));
+    add_transitions(string("Receiver"), Receiver<TIME>(),
+                    bags_of<Receiver<TIME>, receiver_defs::in>(packet));
+    add_transitions(string("Subnet"), Subnet<TIME>(string("subnet1"), 0),
+                    bags_of<Subnet<TIME>, subnet_defs::in>(packet));
+    add_transitions(string("Repeater"), Repeater<TIME>(),
+                    bags_of<Repeater<TIME>, repeater_defs::packet_in>(packet));
+    add_transitions(string("BufferedRepeater"), BufferedRepeater<TIME>(),
+        bags_of<BufferedRepeater<TIME>, repeater_defs::packet_in>(packet));
+    add_transitions(string("Link"), Link<TIME>(),
+                    bags_of<Link<TIME>, subnet_defs::in>(packet));
+    add_transitions(string("WindowSender"), WindowSender<TIME>(),
+        bags_of<WindowSender<TIME>, sender_defs::control_in>(control));
+    add_transitions(string("WindowReceiver"), WindowReceiver<TIME>(),
+        bags_of<WindowReceiver<TIME>, receiver_defs::in>(packet));
+    add_traffic_generator(traffic_spec());
+    add_file_generator();
+
+    add_parser("Parser::next_timed_input/text", BENCH_INPUT_PATH);
+    add_parser("Parser::next_timed_input/compiled", BENCH_EVENTS_PATH);
+    add_write_file(generate_log());
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    remove(BENCH_INPUT_PATH);
+    remove(BENCH_EVENTS_PATH);
+    return 0;
+}
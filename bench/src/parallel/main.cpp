@@ -0,0 +1,183 @@
+/** \brief This file contains the strong scaling benchmark of the parallel runners.
+ *
+ * A topology of K channels, built with abp_topology and a Poisson
+ * traffic generator per channel, is simulated for one hour of
+ * simulated time with the heap runner and then with the parallel
+ * runner and the Time Warp runner with 1, 2, 4, ... up to the given
+ * number of threads. The size of the problem stays the same, so the
+ * speedup over the heap runner shows the strong scaling of the
+ * parallel runners. The Time Warp rows, "tw", are followed by the
+ * steps it rolled back.
+ *
+ * The logger counts the transitions of the atomic models, the
+ * simulated events, and hashes every record it is given, the global
+ * times, the outputs and the states. A row whose hash is that of the
+ * heap runner simulated the same events in the same order.
+ *
+ * The time is the TickTime of integer nanoseconds, so that hashing
+ * a time does not format it.
+ *
+ * Usage: ./PARALLEL_BENCH [channels] [max threads] [hops] ["traffic spec"]
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../../include/message.hpp"
+#include "../../../include/tick_time.hpp"
+#include "../../../include/abp_topology.hpp"
+#include "../../../include/heap_runner.hpp"
+#include "../../../include/parallel_runner.hpp"
+#include "../../../include/timewarp_runner.hpp"
+#include "../../../include/traffic_generator_cadmium.hpp"
+
+#define BENCH_DEFAULT_CHANNELS 1000
+#define BENCH_DEFAULT_MAX_THREADS 64
+#define BENCH_DEFAULT_TRAFFIC "sessions=1 rate=0.01 packets=1:5"
+#define BENCH_RUN_UNTIL "01:00:00:000"
+#define BENCH_WINDOW "00:01:00:000"
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+using TIME = TickTime;
+
+/**
+ * Logger that counts the transitions of the atomic models
+ * and hashes the records with FNV-1a.
+*/
+struct event_digest {
+    static uint64_t events;
+    static uint64_t digest;
+
+    template<typename DECLARED_SOURCE, typename INFO, typename... PARAMs>
+    static void log(const PARAMs&... ps) {
+        if constexpr (std::is_same<DECLARED_SOURCE,
+            cadmium::logger::logger_state>::value) {
+            events++;
+        }
+        (add(ps), ...);
+    }
+
+    static void reset() {
+        events = 0;
+        digest = 14695981039346656037ULL;
+    }
+
+    private:
+        static void add(const TIME &t) {
+            int64_t ticks = t.ticks();
+            add_bytes((const unsigned char *) &ticks, sizeof(ticks));
+        }
+
+        static void add(const string &text) {
+            add_bytes((const unsigned char *) text.data(), text.size());
+        }
+
+        static void add_bytes(const unsigned char *bytes, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                digest = (digest ^ bytes[i]) * 1099511628211ULL;
+            }
+        }
+};
+uint64_t event_digest::events = 0;
+uint64_t event_digest::digest = 0;
+
+static double seconds_since(hclock::time_point start) {
+    return chrono::duration_cast<chrono::duration<double,
+        ratio<1>>>(hclock::now() - start).count();
+}
+
+/**
+ * Function that adds the topology to a runner.
+*/
+template<typename RUNNER>
+static void build(RUNNER &runner, const abp_topology_config &config,
+                  const traffic_spec &spec) {
+    abp_topology<TIME> topology(config);
+    topology.template build_flat<traffic_generator_defs::out>(runner,
+        [&](const string &name, unsigned channel) {
+            traffic_spec channel_spec = spec;
+            channel_spec.seed = spec.seed + channel - 1;
+            runner.template add<TrafficGenerator>(name, channel_spec);
+        }, true);
+}
+
+/**
+ * Function that prints a row of results.
+*/
+static void print_row(const char *threads, size_t partitions,
+                      double run_time, double heap_time,
+                      uint64_t heap_digest) {
+    printf("%-9s %-11zu %-11.4f %-11llu %-11.0f %-9.2f %s\n", threads,
+           partitions, run_time, (unsigned long long) event_digest::events,
+           run_time > 0 ? event_digest::events / run_time : 0.0,
+           run_time > 0 ? heap_time / run_time : 0.0,
+           event_digest::digest == heap_digest ? "yes" : "no");
+    fflush(stdout);
+}
+
+int main(int argc, char ** argv) {
+    abp_topology_config config;
+    config.channels = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_CHANNELS;
+    unsigned max_threads = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_MAX_THREADS;
+    config.hops = argc > 3 ? atoi(argv[3]) : 1;
+    traffic_spec spec;
+    string error;
+    if (config.channels == 0 ||
+        !spec.parse(argc > 4 ? argv[4] : BENCH_DEFAULT_TRAFFIC, error)) {
+        cout << "The topology can not be used: " << error << "\n";
+        return 1;
+    }
+
+    cout << "channels: " << config.channels << ", hops: " << config.hops
+         << ", cores: " << thread::hardware_concurrency() << "\n";
+    cout << "threads   partitions  run (s)     events      events/s    "
+         << "speedup   same log\n";
+
+    heap_runner<TIME, event_digest> heap;
+    build(heap, config, spec);
+    event_digest::reset();
+    heap.start(TIME{0});
+    auto start = hclock::now();
+    heap.run_until(TIME(BENCH_RUN_UNTIL));
+    double heap_time = seconds_since(start);
+    uint64_t heap_digest = event_digest::digest;
+    print_row("heap", 1, heap_time, heap_time, heap_digest);
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        parallel_runner<TIME, event_digest> parallel(threads,
+            TIME(BENCH_WINDOW));
+        build(parallel, config, spec);
+        event_digest::reset();
+        parallel.start(TIME{0});
+        start = hclock::now();
+        parallel.run_until(TIME(BENCH_RUN_UNTIL));
+        double run_time = seconds_since(start);
+        print_row(to_string(threads).c_str(), parallel.partitions(),
+                  run_time, heap_time, heap_digest);
+    }
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        timewarp_runner<TIME, event_digest> timewarp(threads,
+            TIME(BENCH_WINDOW));
+        build(timewarp, config, spec);
+        event_digest::reset();
+        timewarp.start(TIME{0});
+        start = hclock::now();
+        timewarp.run_until(TIME(BENCH_RUN_UNTIL));
+        double run_time = seconds_since(start);
+        print_row(("tw " + to_string(threads)).c_str(), timewarp.processes(),
+                  run_time, heap_time, heap_digest);
+        cout << "          rolled back: " << timewarp.rolled_back()
+             << " of " << timewarp.steps() << " steps\n";
+    }
+    return 0;
+}
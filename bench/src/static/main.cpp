@@ -0,0 +1,159 @@
+/** \brief This file contains the static runner benchmark of the ABP model.
+ *
+ * The one channel ABP model is simulated with the dynamic runner,
+ * built by abp_topology as in ABP, and with the static runner,
+ * declared in abp_static.hpp as in ABP_STATIC. Both get their
+ * control messages from the same Poisson traffic generator and
+ * run for the given number of simulated hours. The time taken to
+ * create the runner and to simulate is printed, with the simulated
+ * events per second and the peak resident memory.
+ * A simulated event is a transition of an atomic model; they are
+ * counted by a logger of the state source, which formats nothing.
+ *
+ * Every runner is run in a process of its own, so the peak memory
+ * of one does not hide that of the other.
+ *
+ * Usage: ./STATIC_BENCH [hours] ["traffic spec"]
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cadmium/modeling/dynamic_model_translator.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/engine/pdevs_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../../include/message.hpp"
+#include "../../../include/abp_static.hpp"
+#include "../../../include/abp_topology.hpp"
+#include "../../../include/traffic_generator_cadmium.hpp"
+
+#define BENCH_DEFAULT_HOURS 10000
+#define BENCH_DEFAULT_TRAFFIC "sessions=1 rate=0.001 packets=1:5"
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+using TIME = NDTime;
+
+/**
+ * Logger that counts the transitions of the atomic models.
+*/
+struct event_counter {
+    static uint64_t events;
+
+    template<typename DECLARED_SOURCE, typename INFO, typename... PARAMs>
+    static void log(const PARAMs&... ps) {
+        if constexpr (std::is_same<DECLARED_SOURCE,
+            cadmium::logger::logger_state>::value) {
+            events++;
+        }
+    }
+};
+uint64_t event_counter::events = 0;
+
+/**
+ * The static runner constructs the generator itself,
+ * so it reads the traffic spec set in main
+*/
+static traffic_spec bench_spec;
+
+template<typename T>
+class generator_con : public TrafficGenerator<T> {
+public:
+    generator_con() : TrafficGenerator<T>(bench_spec) {}
+};
+
+using TOP = abp_static_top<generator_con, traffic_generator_defs::out>;
+
+static double seconds_since(hclock::time_point start) {
+    return chrono::duration_cast<chrono::duration<double,
+        ratio<1>>>(hclock::now() - start).count();
+}
+
+/**
+ * Function that prints a row of results, with
+ * the peak resident memory of the process.
+*/
+static void print_row(const char *runner, double runner_time,
+                      double run_time) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%-9s %-11.4f %-11.4f %-11llu %-11.0f %ld\n", runner,
+           runner_time, run_time, (unsigned long long) event_counter::events,
+           run_time > 0 ? event_counter::events / run_time : 0.0,
+           usage.ru_maxrss);
+    fflush(stdout);
+}
+
+static void run_dynamic(TIME until) {
+    auto start = hclock::now();
+    abp_topology<TIME> topology{abp_topology_config()};
+    auto make_generator = [&](const string &name, unsigned channel) {
+        return cadmium::dynamic::translate::make_dynamic_atomic_model
+            <TrafficGenerator, TIME, traffic_spec>(name,
+                traffic_spec(bench_spec));
+    };
+    auto top = topology.build<traffic_generator_defs::out>(
+        make_generator, true);
+    cadmium::dynamic::engine::runner<TIME, event_counter> r(top, {0});
+    double runner_time = seconds_since(start);
+
+    event_counter::events = 0;
+    start = hclock::now();
+    r.run_until(until);
+    print_row("dynamic", runner_time, seconds_since(start));
+}
+
+static void run_static(TIME until) {
+    auto start = hclock::now();
+    cadmium::engine::runner<TIME, TOP::type, event_counter> r(TIME{0});
+    double runner_time = seconds_since(start);
+
+    event_counter::events = 0;
+    start = hclock::now();
+    r.runUntil(until);
+    print_row("static", runner_time, seconds_since(start));
+}
+
+int main(int argc, char ** argv) {
+    int hours = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_HOURS;
+    string error;
+    if (!bench_spec.parse(argc > 2 ? argv[2] : BENCH_DEFAULT_TRAFFIC, error)) {
+        cout << "The traffic spec can not be used: " << error << "\n";
+        return 1;
+    }
+    TIME until({hours, 0, 0, 0});
+
+    cout << "runner    runner (s)  run (s)     events      events/s    "
+         << "peak memory (KB)\n";
+    fflush(stdout);
+    for (void (*run)(TIME) : {run_dynamic, run_static}) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            cout << "The benchmark process can not be created, errno = "
+                 << errno << "\n";
+            return 1;
+        }
+        if (pid == 0) {
+            run(until);
+            _exit(0);
+        }
+        int status;
+        waitpid(pid, &status, 0);
+    }
+    return 0;
+}
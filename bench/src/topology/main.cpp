@@ -0,0 +1,175 @@
+/** \brief This file contains the scaling benchmark of the ABP topology.
+ *
+ * For every number of channels K the topology is built with
+ * abp_topology and a Poisson traffic generator per channel, and
+ * simulated for one hour of simulated time. The time taken to
+ * create the model, to create the runner and to simulate is
+ * printed, together with the simulated events per second.
+ * A simulated event is a transition of an atomic model; they are
+ * counted by a logger of the state source, which is called after
+ * every transition and formats nothing.
+ *
+ * Every size is run with the NDTime of DESTimes and with the
+ * TickTime of integer nanoseconds, so the cost of the time type
+ * shows in the events per second of the two rows, and with the
+ * Cadmium runner and the heap runner, which visits only the models
+ * with events.
+ *
+ * Usage: ./TOPOLOGY_BENCH [max channels] [hops] ["traffic spec"]
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+
+#include <cadmium/modeling/dynamic_model_translator.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../../../lib/DESTimes/include/NDTime.hpp"
+
+#include "../../../include/message.hpp"
+#include "../../../include/tick_time.hpp"
+#include "../../../include/abp_topology.hpp"
+#include "../../../include/heap_runner.hpp"
+#include "../../../include/traffic_generator_cadmium.hpp"
+
+#define BENCH_DEFAULT_MAX_CHANNELS 10000
+#define BENCH_DEFAULT_TRAFFIC "sessions=1 rate=0.01 packets=1:5"
+#define BENCH_RUN_UNTIL "01:00:00:000"
+
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+
+/**
+ * Logger that counts the transitions of the atomic models.
+*/
+struct event_counter {
+    static uint64_t events;
+
+    template<typename DECLARED_SOURCE, typename INFO, typename... PARAMs>
+    static void log(const PARAMs&... ps) {
+        if constexpr (std::is_same<DECLARED_SOURCE,
+            cadmium::logger::logger_state>::value) {
+            events++;
+        }
+    }
+};
+uint64_t event_counter::events = 0;
+
+static double seconds_since(hclock::time_point start) {
+    return chrono::duration_cast<chrono::duration<double,
+        ratio<1>>>(hclock::now() - start).count();
+}
+
+/**
+ * Function that prints a row of results.
+*/
+static void print_row(unsigned k, const char *runner_name,
+                      const char *time_name, size_t atomics,
+                      double model_time, double runner_time, double run_time) {
+    printf("%-9u %-9s %-9s %-9zu %-11.4f %-11.4f %-11.4f %-11llu %.0f\n", k,
+           runner_name, time_name, atomics, model_time, runner_time,
+           run_time, (unsigned long long) event_counter::events,
+           run_time > 0 ? event_counter::events / run_time : 0.0);
+    fflush(stdout);
+}
+
+/**
+ * Function that builds and runs the topology of k channels with
+ * the time type TIME and the Cadmium runner.
+*/
+template<typename TIME>
+static void run_topology(const char *time_name, unsigned k, unsigned hops,
+                         const traffic_spec &spec) {
+    abp_topology_config config;
+    config.channels = k;
+    config.hops = hops;
+    abp_topology<TIME> topology(config);
+    auto make_generator = [&](const string &name, unsigned channel) {
+        traffic_spec channel_spec = spec;
+        channel_spec.seed = spec.seed + channel - 1;
+        return cadmium::dynamic::translate::make_dynamic_atomic_model
+            <TrafficGenerator, TIME, traffic_spec>(name,
+                std::move(channel_spec));
+    };
+
+    auto start = hclock::now();
+    auto TOP = topology.template build<traffic_generator_defs::out>(
+        make_generator, true);
+    double model_time = seconds_since(start);
+
+    start = hclock::now();
+    cadmium::dynamic::engine::runner<TIME, event_counter> r(TOP, {0});
+    double runner_time = seconds_since(start);
+
+    event_counter::events = 0;
+    start = hclock::now();
+    r.run_until(TIME(BENCH_RUN_UNTIL));
+    double run_time = seconds_since(start);
+
+    print_row(k, "cadmium", time_name, topology.atomic_models() + k,
+              model_time, runner_time, run_time);
+}
+
+/**
+ * Function that builds and runs the topology of k channels with
+ * the time type TIME and the heap runner.
+*/
+template<typename TIME>
+static void run_topology_heap(const char *time_name, unsigned k,
+                              unsigned hops, const traffic_spec &spec) {
+    abp_topology_config config;
+    config.channels = k;
+    config.hops = hops;
+    abp_topology<TIME> topology(config);
+    heap_runner<TIME, event_counter> r;
+
+    auto start = hclock::now();
+    topology.template build_flat<traffic_generator_defs::out>(r,
+        [&](const string &name, unsigned channel) {
+            traffic_spec channel_spec = spec;
+            channel_spec.seed = spec.seed + channel - 1;
+            r.template add<TrafficGenerator>(name, channel_spec);
+        }, true);
+    double model_time = seconds_since(start);
+
+    start = hclock::now();
+    r.start(TIME{0});
+    double runner_time = seconds_since(start);
+
+    event_counter::events = 0;
+    start = hclock::now();
+    r.run_until(TIME(BENCH_RUN_UNTIL));
+    double run_time = seconds_since(start);
+
+    print_row(k, "heap", time_name, r.models(), model_time, runner_time,
+              run_time);
+}
+
+int main(int argc, char ** argv) {
+    unsigned max_channels = argc > 1 ? atoi(argv[1]) :
+        BENCH_DEFAULT_MAX_CHANNELS;
+    unsigned hops = argc > 2 ? atoi(argv[2]) : 1;
+    traffic_spec spec;
+    string error;
+    if (!spec.parse(argc > 3 ? argv[3] : BENCH_DEFAULT_TRAFFIC, error)) {
+        cout << "The traffic spec can not be used: " << error << "\n";
+        return 1;
+    }
+
+    cout << "channels  runner    time      atomics   model (s)   runner (s)  "
+         << "run (s)     events      events/s\n";
+    for (unsigned k = 1; k <= max_channels; k *= 10) {
+        run_topology<NDTime>("NDTime", k, hops, spec);
+        run_topology<TickTime>("TickTime", k, hops, spec);
+        run_topology_heap<NDTime>("NDTime", k, hops, spec);
+        run_topology_heap<TickTime>("TickTime", k, hops, spec);
+    }
+    return 0;
+}
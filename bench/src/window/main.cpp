@@ -0,0 +1,94 @@
+/** \brief This file contains the window size benchmark of the ABP model.
+ *
+ * For go back N and selective repeat and every window size W, the
+ * channel of the topology is simulated with a WindowSender and a
+ * WindowReceiver, sending packets for the whole run, and the
+ * stop and wait Sender is simulated as the baseline. The loss and
+ * the delay of the Subnets are given in the topology, as
+ * "delivery=0.9 delay_mean=3". Every setting is replicated R times
+ * on all cores and the mean goodput is printed with its 95%
+ * confidence interval, with the retransmission rate and the mean
+ * acknowledgement latency.
+ *
+ * Usage: ./WINDOW_BENCH [replications] [max window] ["topology"]
+*/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../include/abp_topology.hpp"
+#include "../../../include/parameter_sweep.hpp"
+#include "../../../include/replication_metrics.hpp"
+#include "../../../include/replication_runner.hpp"
+
+#define BENCH_DEFAULT_REPLICATIONS 10
+#define BENCH_DEFAULT_MAX_WINDOW 32
+#define BENCH_TRAFFIC "sessions=1 rate=1 packets=1"
+
+using namespace std;
+
+/**
+ * Structure that holds one setting of the benchmark.
+*/
+struct setting_type {
+    const char *protocol;
+    int window;
+};
+
+int main(int argc, char ** argv) {
+    unsigned replications = argc > 1 ? atoi(argv[1]) :
+        BENCH_DEFAULT_REPLICATIONS;
+    int max_window = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_MAX_WINDOW;
+    abp_topology_config config;
+    replication_input input;
+    string error;
+    if (argc > 3 && !config.parse(argv[3], error)) {
+        cout << "The topology can not be used: " << error << "\n";
+        return 1;
+    }
+    input.traffic = true;
+    input.spec.parse(BENCH_TRAFFIC, error);
+
+    vector<setting_type> settings = {{"abp", 1}};
+    for (const char *protocol : {"gbn", "sr"}) {
+        for (int w = 1; w <= max_window; w *= 2) {
+            settings.push_back({protocol, w});
+        }
+    }
+    vector<abp_topology_config> configs(settings.size(), config);
+    for (size_t s = 0; s < settings.size(); s++) {
+        string text = string("protocol=") + settings[s].protocol +
+            " window=" + to_string(settings[s].window) + " seq_space=0";
+        configs[s].parse(text.c_str(), error);
+    }
+
+    vector<replication_metrics> metrics(settings.size() * replications);
+    work_stealing_pool pool(thread::hardware_concurrency());
+    pool.run(metrics.size(), [&](size_t run) {
+        metrics[run] = run_replication(run % replications, input,
+                                       configs[run / replications]);
+    });
+
+    printf("%-9s %-7s %-28s %-20s %s\n", "protocol", "window",
+           "goodput (packets/s)", "retransmission rate", "ack latency (s)");
+    vector<double> goodput(replications), retransmission(replications),
+        latency(replications);
+    for (size_t s = 0; s < settings.size(); s++) {
+        for (unsigned r = 0; r < replications; r++) {
+            const replication_metrics &m = metrics[s * replications + r];
+            goodput[r] = m.goodput();
+            retransmission[r] = m.retransmission_rate();
+            latency[r] = m.ack_latency();
+        }
+        metric_summary g = summarize(goodput);
+        printf("%-9s %-7d %-11.6g +- %-12.6g %-20.6g %.6g\n",
+               settings[s].protocol, settings[s].window, g.mean,
+               g.half_width, summarize(retransmission).mean,
+               summarize(latency).mean);
+    }
+    return 0;
+}
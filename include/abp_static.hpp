@@ -0,0 +1,164 @@
+/** \brief This header file declares the ABP model as static coupled models.
+ *
+ * The one channel topology that abp_topology builds by default,
+ *
+ *   TOP: generator_con, ABPSimulator
+ *   ABPSimulator: sender1, receiver1, Network
+ *   Network: subnet1, subnet2, repeater1, subnet3, subnet4
+ *
+ * is declared here as coupled models of types, for the static PDEVS
+ * runner of Cadmium. The couplings are resolved at compile time, so
+ * messages are passed between the models without the shared pointers,
+ * port lookups and type erased bags of the dynamic runner.
+ *
+ * The static runner tells the models apart by their types, so every
+ * atomic model is a class of its own, named as the dynamic model it
+ * stands for. The models have the default constants of the topology
+ * and the Subnets draw the random streams of their names with seed
+ * 0, as the dynamic ones do.
+*/
+
+#ifndef __ABP_STATIC_HPP__
+#define __ABP_STATIC_HPP__
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/coupled_model.hpp>
+
+#include <tuple>
+
+#include "abp_topology.hpp"
+#include "sender_cadmium.hpp"
+#include "receiver_cadmium.hpp"
+#include "subnet_cadmium.hpp"
+#include "repeater_cadmium.hpp"
+
+#define ABP_STATIC_SEED 0
+
+/**
+ * Atomic models of the channel.
+*/
+template<typename TIME>
+class sender1 : public Sender<TIME> {
+};
+
+template<typename TIME>
+class receiver1 : public Receiver<TIME> {
+};
+
+template<typename TIME>
+class repeater1 : public Repeater<TIME> {
+};
+
+template<typename TIME>
+class subnet1 : public Subnet<TIME> {
+    public:
+        subnet1() noexcept : Subnet<TIME>("subnet1", ABP_STATIC_SEED) {
+        }
+};
+
+template<typename TIME>
+class subnet2 : public Subnet<TIME> {
+    public:
+        subnet2() noexcept : Subnet<TIME>("subnet2", ABP_STATIC_SEED) {
+        }
+};
+
+template<typename TIME>
+class subnet3 : public Subnet<TIME> {
+    public:
+        subnet3() noexcept : Subnet<TIME>("subnet3", ABP_STATIC_SEED) {
+        }
+};
+
+template<typename TIME>
+class subnet4 : public Subnet<TIME> {
+    public:
+        subnet4() noexcept : Subnet<TIME>("subnet4", ABP_STATIC_SEED) {
+        }
+};
+
+/**
+ * Network: the Subnets and the Repeater between them.
+*/
+using iports_Network = std::tuple<inp_1, inp_2>;
+using oports_Network = std::tuple<outp_1, outp_2>;
+using submodels_Network = cadmium::modeling::models_tuple<subnet1, subnet2,
+    repeater1, subnet3, subnet4>;
+using eics_Network = std::tuple<
+    cadmium::modeling::EIC<inp_1, subnet1, subnet_defs::in>,
+    cadmium::modeling::EIC<inp_2, subnet4, subnet_defs::in>
+>;
+using eocs_Network = std::tuple<
+    cadmium::modeling::EOC<subnet2, subnet_defs::out, outp_1>,
+    cadmium::modeling::EOC<subnet3, subnet_defs::out, outp_2>
+>;
+using ics_Network = std::tuple<
+    cadmium::modeling::IC<repeater1, repeater_defs::ack_received_out,
+        subnet2, subnet_defs::in>,
+    cadmium::modeling::IC<subnet1, subnet_defs::out,
+        repeater1, repeater_defs::packet_in>,
+    cadmium::modeling::IC<repeater1, repeater_defs::packet_sent_out,
+        subnet3, subnet_defs::in>,
+    cadmium::modeling::IC<subnet4, subnet_defs::out,
+        repeater1, repeater_defs::ack_in>
+>;
+
+template<typename TIME>
+using Network = cadmium::modeling::coupled_model<TIME, iports_Network,
+    oports_Network, submodels_Network, eics_Network, eocs_Network,
+    ics_Network>;
+
+/**
+ * ABPSimulator: the Sender, the Receiver and the Network.
+*/
+using iports_ABPSimulator = std::tuple<inp_control>;
+using oports_ABPSimulator = std::tuple<outp_ack, outp_pack>;
+using submodels_ABPSimulator = cadmium::modeling::models_tuple<sender1,
+    receiver1, Network>;
+using eics_ABPSimulator = std::tuple<
+    cadmium::modeling::EIC<inp_control, sender1, sender_defs::control_in>
+>;
+using eocs_ABPSimulator = std::tuple<
+    cadmium::modeling::EOC<sender1, sender_defs::packet_sent_out, outp_pack>,
+    cadmium::modeling::EOC<sender1, sender_defs::ack_received_out, outp_ack>
+>;
+using ics_ABPSimulator = std::tuple<
+    cadmium::modeling::IC<sender1, sender_defs::data_out, Network, inp_1>,
+    cadmium::modeling::IC<Network, outp_1, sender1, sender_defs::ack_in>,
+    cadmium::modeling::IC<receiver1, receiver_defs::out, Network, inp_2>,
+    cadmium::modeling::IC<Network, outp_2, receiver1, receiver_defs::in>
+>;
+
+template<typename TIME>
+using ABPSimulator = cadmium::modeling::coupled_model<TIME,
+    iports_ABPSimulator, oports_ABPSimulator, submodels_ABPSimulator,
+    eics_ABPSimulator, eocs_ABPSimulator, ics_ABPSimulator>;
+
+/**
+ * TOP: the generator of the control messages and the channel.
+ * GENERATOR is the generator model, default constructible, and
+ * GENERATOR_OUT its output port; TOP is used as
+ * abp_static_top<GENERATOR, GENERATOR_OUT>::template type.
+*/
+template<template<typename> class GENERATOR, typename GENERATOR_OUT>
+struct abp_static_top {
+    using iports = std::tuple<>;
+    using oports = std::tuple<outp_pack, outp_ack>;
+    using submodels = cadmium::modeling::models_tuple<GENERATOR,
+        ABPSimulator>;
+    using eics = std::tuple<>;
+    using eocs = std::tuple<
+        cadmium::modeling::EOC<ABPSimulator, outp_pack, outp_pack>,
+        cadmium::modeling::EOC<ABPSimulator, outp_ack, outp_ack>
+    >;
+    using ics = std::tuple<
+        cadmium::modeling::IC<GENERATOR, GENERATOR_OUT,
+            ABPSimulator, inp_control>
+    >;
+
+    template<typename TIME>
+    using type = cadmium::modeling::coupled_model<TIME, iports, oports,
+        submodels, eics, eocs, ics>;
+};
+
+#endif // __ABP_STATIC_HPP__
@@ -0,0 +1,630 @@
+/** \brief This header file implements the ABP topology builder.
+ *
+ * The builder produces the coupled model of K parallel ABP channels.
+ * Every channel is a Sender and a Receiver connected through a
+ * Network of H Repeaters, with a pair of Subnets (one for packets,
+ * one for acknowledgements) before, between and after them:
+ *
+ * sender --> subnet --> repeater --> ... --> subnet --> receiver
+ *        <-- subnet <--          <-- ... <-- subnet <--
+ *
+ * The control messages of all channels come either from one
+ * generator connected to every Sender or from one generator per
+ * channel. Atomic models are numbered across channels, so that a
+ * single channel with one hop has the names of the original model:
+ * generator_con, sender1, receiver1, subnet1 to subnet4, repeater1.
+ * The constants of the models are part of the config; their
+ * defaults are the constants of the original model. With the
+ * protocol gbn or sr every channel has a WindowSender and a
+ * WindowReceiver, with the window and sequence number space of
+ * the config, instead of the Sender and the Receiver. With
+ * link=queue every Subnet is replaced by a Link, which carries any
+ * number of packets at once at the bandwidth of the config. With
+ * repeater=buffered every Repeater is a BufferedRepeater with the
+ * buffers of the config.
+ *
+ * By default the hierarchy is flattened: all atomic models are
+ * put in the TOP model and coupled to one another directly, so a
+ * message is routed once instead of through the ABPSimulator and
+ * Network couplings of its channel. The models, their order and
+ * thus the log are the same. With hierarchy=nested the channels
+ * are built as ABPSimulator and Network coupled models, as in the
+ * original model, which helps when debugging the couplings.
+ * build_flat adds the models of the flattened TOP model to another
+ * model sink, as the heap_runner of scheduler=heap, the
+ * parallel_runner of scheduler=parallel and the timewarp_runner
+ * of scheduler=timewarp.
+*/
+
+#ifndef __ABP_TOPOLOGY_HPP__
+#define __ABP_TOPOLOGY_HPP__
+
+#include <cadmium/modeling/coupling.hpp>
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/dynamic_model_translator.hpp>
+#include <cadmium/modeling/dynamic_coupled.hpp>
+#include <cadmium/modeling/dynamic_atomic.hpp>
+
+#include <math.h>
+#include <stdint.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "message.hpp"
+#include "sender_cadmium.hpp"
+#include "receiver_cadmium.hpp"
+#include "subnet_cadmium.hpp"
+#include "repeater_cadmium.hpp"
+#include "buffered_repeater_cadmium.hpp"
+#include "link_cadmium.hpp"
+#include "window_sender_cadmium.hpp"
+#include "window_receiver_cadmium.hpp"
+#include "time_ticks.hpp"
+
+/***** SETING INPUT PORTS FOR COUPLEDs *****/
+struct inp_control : public cadmium::in_port<Message_t>{};
+struct inp_1 : public cadmium::in_port<Message_t>{};
+struct inp_2 : public cadmium::in_port<Message_t>{};
+/***** SETING OUTPUT PORTS FOR COUPLEDs *****/
+struct outp_ack : public cadmium::out_port<Message_t>{};
+struct outp_1 : public cadmium::out_port<Message_t>{};
+struct outp_2 : public cadmium::out_port<Message_t>{};
+struct outp_pack : public cadmium::out_port<Message_t>{};
+
+/**
+ * Protocol of the channels.
+*/
+enum class channel_protocol {
+    abp,                //!< Sender and Receiver.
+    go_back_n,          //!< Window models with go back N.
+    selective_repeat    //!< Window models with selective repeat.
+};
+
+/**
+ * Structure that holds the size of the topology and the constants
+ * of its models. It is built from space separated key=value pairs,
+ * as "channels=100 hops=3 seed=7 timeout=30". Times are in seconds.
+*/
+struct abp_topology_config {
+    unsigned channels = 1;    //!< Number of parallel ABP channels.
+    unsigned hops = 1;        //!< Number of Repeaters in every channel.
+    uint64_t seed = 0;        //!< Seed of the random streams of the Subnets.
+    double sender_preparation = 10;     //!< Sender PREPARATION_TIME.
+    double timeout = 60;                //!< Sender TIMEOUT.
+    double receiver_preparation = 10;   //!< Receiver PREPARATION_TIME.
+    double repeater_preparation = 10;   //!< Repeater PREPARATION_TIME.
+    double delivery = 0.95;             //!< Subnet delivery probability.
+    double delay_mean = 3;              //!< Subnet mean delay.
+    double delay_stddev = 1;            //!< Subnet delay standard deviation.
+    channel_protocol protocol = channel_protocol::abp;   //!< Protocol.
+    int window = 1;           //!< Window of the window models.
+    int seq_space = 0;        //!< Sequence numbers, 0 for the fewest.
+    bool adaptive_timeout = false;   //!< Sender timeout from the RTT.
+    bool queue_links = false;   //!< Links instead of Subnets.
+    double bandwidth = 0;       //!< Link packets per second, 0 unlimited.
+    bool buffered_repeaters = false;   //!< BufferedRepeaters.
+    repeater_buffer_config buffer;     //!< Buffers of the BufferedRepeaters.
+    bool flat = true;           //!< Atomic models coupled directly.
+    bool heap_scheduler = false;   //!< heap_runner instead of Cadmium.
+    bool parallel_scheduler = false;   //!< parallel_runner of heap_runners.
+    bool timewarp_scheduler = false;   //!< Optimistic timewarp_runner.
+    unsigned threads = 0;     //!< Threads of the parallel runners, 0 per core.
+
+    /**
+     * Function that reads the config.
+     * @param text config string
+     * @param error description of the first wrong parameter
+     * @return true if the config is valid
+    */
+    bool parse(const char *text, std::string &error) {
+        std::istringstream in(text);
+        std::string item;
+        while (in >> item) {
+            size_t eq = item.find('=');
+            std::string key = item.substr(0, eq);
+            std::istringstream value(eq == std::string::npos ? "" :
+                                     item.substr(eq + 1));
+            bool ok = false;
+            if (key == "channels") {
+                ok = (value >> channels) && value.eof() && channels > 0;
+            }
+            else if (key == "hops") {
+                ok = (value >> hops) && value.eof();
+            }
+            else if (key == "seed") {
+                ok = (value >> seed) && value.eof();
+            }
+            else if (key == "delivery") {
+                ok = (value >> delivery) && value.eof() &&
+                     delivery >= 0 && delivery <= 1;
+            }
+            else if (double *seconds = time_parameter(key)) {
+                ok = (value >> *seconds) && value.eof() && *seconds >= 0;
+            }
+            else if (key == "protocol") {
+                std::string name = value.str();
+                ok = name == "abp" || name == "gbn" || name == "sr";
+                protocol = name == "gbn" ? channel_protocol::go_back_n :
+                    name == "sr" ? channel_protocol::selective_repeat :
+                        channel_protocol::abp;
+            }
+            else if (key == "window") {
+                ok = (value >> window) && value.eof() && window > 0;
+            }
+            else if (key == "seq_space") {
+                ok = (value >> seq_space) && value.eof() && seq_space >= 0;
+            }
+            else if (key == "adaptive_timeout") {
+                ok = (value >> adaptive_timeout) && value.eof();
+            }
+            else if (key == "link") {
+                ok = value.str() == "subnet" || value.str() == "queue";
+                queue_links = value.str() == "queue";
+            }
+            else if (key == "bandwidth") {
+                ok = (value >> bandwidth) && value.eof() && bandwidth >= 0;
+            }
+            else if (key == "repeater") {
+                ok = value.str() == "single" || value.str() == "buffered";
+                buffered_repeaters = value.str() == "buffered";
+            }
+            else if (key == "buffer") {
+                ok = (value >> buffer.capacity) && value.eof() &&
+                     buffer.capacity > 0;
+            }
+            else if (key == "service_rate") {
+                ok = (value >> buffer.service_rate) && value.eof() &&
+                     buffer.service_rate > 0;
+            }
+            else if (key == "queue_policy") {
+                ok = value.str() == "droptail" || value.str() == "red";
+                buffer.policy = value.str() == "red" ? queue_policy::red :
+                    queue_policy::drop_tail;
+            }
+            else if (key == "hierarchy") {
+                ok = value.str() == "flat" || value.str() == "nested";
+                flat = value.str() == "flat";
+            }
+            else if (key == "scheduler") {
+                ok = value.str() == "cadmium" || value.str() == "heap" ||
+                     value.str() == "parallel" || value.str() == "timewarp";
+                heap_scheduler = value.str() != "cadmium";
+                parallel_scheduler = value.str() == "parallel";
+                timewarp_scheduler = value.str() == "timewarp";
+            }
+            else if (key == "threads") {
+                ok = (value >> threads) && value.eof();
+            }
+            if (!ok) {
+                error = "wrong topology parameter " + item;
+                return false;
+            }
+        }
+        if (heap_scheduler && !flat) {
+            error = std::string("scheduler=") + (parallel_scheduler ?
+                "parallel" : timewarp_scheduler ? "timewarp" : "heap") +
+                " runs the flat hierarchy only";
+            return false;
+        }
+        if (protocol != channel_protocol::abp && seq_space != 0 &&
+            seq_space < window_min_seq_space(window, mode())) {
+            error = "seq_space " + std::to_string(seq_space) +
+                " is too small for window " + std::to_string(window);
+            return false;
+        }
+        return true;
+    }
+
+    /** @return retransmission strategy of the window models */
+    window_mode mode() const {
+        return protocol == channel_protocol::selective_repeat ?
+            window_mode::selective_repeat : window_mode::go_back_n;
+    }
+
+    /** @return sequence number space of the window models */
+    int window_seq_space() const {
+        return seq_space != 0 ? seq_space :
+            window_min_seq_space(window, mode());
+    }
+
+    /**
+     * Function that returns the parameter of a key that holds
+     * a time or a delay, or nullptr for other keys.
+    */
+    double *time_parameter(const std::string &key) {
+        if (key == "sender_preparation") return &sender_preparation;
+        if (key == "timeout") return &timeout;
+        if (key == "receiver_preparation") return &receiver_preparation;
+        if (key == "repeater_preparation") return &repeater_preparation;
+        if (key == "delay_mean") return &delay_mean;
+        if (key == "delay_stddev") return &delay_stddev;
+        return nullptr;
+    }
+};
+
+/**
+ * Structure that collects the dynamic models of a coupled model
+ * and their couplings. It is the model sink of abp_topology for
+ * the Cadmium runner; a sink adds a model with add, couples the
+ * models with couple and connects a model to the output ports of
+ * the TOP model with output.
+*/
+template<typename TIME>
+struct dynamic_model_sink {
+    cadmium::dynamic::modeling::Models models;
+    cadmium::dynamic::modeling::EOCs eocs;
+    cadmium::dynamic::modeling::ICs ics;
+
+    template<template<typename> class MODEL, typename... ARGS>
+    void add(const std::string &name, ARGS... args) {
+        models.push_back(cadmium::dynamic::translate::make_dynamic_atomic_model
+            <MODEL, TIME, ARGS...>(name, std::move(args)...));
+    }
+
+    template<typename FROM_PORT, typename TO_PORT>
+    void couple(const std::string &from, const std::string &to) {
+        ics.push_back(cadmium::dynamic::translate::make_IC
+            <FROM_PORT, TO_PORT>(from, to));
+    }
+
+    template<typename FROM_PORT, typename TO_PORT>
+    void output(const std::string &from) {
+        eocs.push_back(cadmium::dynamic::translate::make_EOC
+            <FROM_PORT, TO_PORT>(from));
+    }
+};
+
+/**
+ * The abp_topology class builds the coupled models of the topology.
+*/
+template<typename TIME>
+class abp_topology {
+    using coupled_ptr =
+        std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>>;
+    public:
+        explicit abp_topology(abp_topology_config config) :
+            _config(config) {
+        }
+
+        /**
+         * Function that builds the TOP model.
+         * GENERATOR_OUT is the output port of the generators.
+         * @param make_generator function that returns the generator
+         *        for a name and a channel (0 for a shared generator)
+         * @param generator_per_channel true for one generator per channel,
+         *        whose arrivals the Senders queue
+         * @return TOP model
+        */
+        template<typename GENERATOR_OUT, typename MAKE_GENERATOR>
+        coupled_ptr build(MAKE_GENERATOR make_generator,
+                          bool generator_per_channel) const {
+            dynamic_model_sink<TIME> top;
+            unsigned generators = generator_per_channel ? _config.channels : 1;
+            auto add_generator = [&](const std::string &name,
+                                     unsigned channel) {
+                top.models.push_back(make_generator(name, channel));
+            };
+
+            top.models.reserve(generators + (_config.flat ?
+                atomic_models() : _config.channels));
+            top.eocs.reserve(2 * _config.channels);
+            top.ics.reserve(_config.flat ? (size_t) _config.channels *
+                (5 + 4 * _config.hops) : _config.channels);
+            if (_config.flat) {
+                build_flat<GENERATOR_OUT>(top, add_generator,
+                                          generator_per_channel);
+            }
+            else {
+                for (unsigned g = 1; g <= generators; g++) {
+                    add_generator(generator_name(generators, g),
+                                  generator_per_channel ? g : 0);
+                }
+                for (unsigned k = 1; k <= _config.channels; k++) {
+                    std::string channel = coupled_name("ABPSimulator", k);
+                    top.models.push_back(make_channel(k,
+                        generator_per_channel));
+                    top.template output<outp_pack,outp_pack>(channel);
+                    top.template output<outp_ack,outp_ack>(channel);
+                    top.template couple<GENERATOR_OUT,inp_control>(
+                        generator_name(generators, k), channel);
+                }
+            }
+
+            return std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(
+                "TOP",
+                top.models,
+                cadmium::dynamic::modeling::Ports{},
+                cadmium::dynamic::modeling::Ports{typeid(outp_pack),
+                    typeid(outp_ack)},
+                cadmium::dynamic::modeling::EICs{},
+                top.eocs,
+                top.ics
+            );
+        }
+
+        /**
+         * Function that adds the atomic models of the flattened TOP
+         * model and their couplings to a model sink, as
+         * dynamic_model_sink or heap_runner.
+         * GENERATOR_OUT is the output port of the generators.
+         * @param sink model sink
+         * @param add_generator function that adds the generator of
+         *        a name and a channel (0 for a shared generator)
+         * @param generator_per_channel true for one generator per channel,
+         *        whose arrivals the Senders queue
+        */
+        template<typename GENERATOR_OUT, typename SINK, typename ADD_GENERATOR>
+        void build_flat(SINK &sink, ADD_GENERATOR add_generator,
+                        bool generator_per_channel) const {
+            unsigned generators = generator_per_channel ? _config.channels : 1;
+            for (unsigned g = 1; g <= generators; g++) {
+                add_generator(generator_name(generators, g),
+                              generator_per_channel ? g : 0);
+            }
+            for (unsigned k = 1; k <= _config.channels; k++) {
+                add_flat_channel<GENERATOR_OUT>(sink, k,
+                    generator_name(generators, k), generator_per_channel);
+            }
+        }
+
+        /**
+         * @return number of atomic models of the channels
+        */
+        size_t atomic_models() const {
+            return (size_t) _config.channels * (2 + _config.hops +
+                2 * (_config.hops + 1));
+        }
+
+    private:
+        abp_topology_config _config;
+
+        /**
+         * Function that converts seconds of the config to TIME.
+        */
+        static TIME seconds(double s) {
+            return ticks_to_time<TIME>(llround(s * 1000));
+        }
+
+        /**
+         * Function that returns the name of the generator of a
+         * channel; a single generator is shared by all channels.
+        */
+        static std::string generator_name(unsigned generators,
+                                          unsigned channel) {
+            return generators == 1 ? std::string("generator_con") :
+                "generator_con" + std::to_string(channel);
+        }
+
+        /**
+         * Function that returns the name of a coupled model; with
+         * a single channel the channel number is left out.
+        */
+        std::string coupled_name(const char *name, unsigned channel) const {
+            return _config.channels == 1 ? std::string(name) :
+                name + std::to_string(channel);
+        }
+
+        /**
+         * Function that returns the name of subnet number n of the
+         * channel. Every hop segment has two, packets first.
+        */
+        std::string subnet_name(unsigned channel, unsigned n) const {
+            return "subnet" + std::to_string((size_t) (channel - 1) *
+                2 * (_config.hops + 1) + n);
+        }
+
+        std::string repeater_name(unsigned channel, unsigned hop) const {
+            return "repeater" + std::to_string((size_t) (channel - 1) *
+                _config.hops + hop);
+        }
+
+        /**
+         * Function that adds a Subnet, or a Link, with the random
+         * stream of its name in the run.
+        */
+        template<typename SINK>
+        void add_subnet(SINK &sink, const std::string &name) const {
+            if (_config.queue_links) {
+                sink.template add<Link>(name, std::string(name),
+                    uint64_t(_config.seed), double(_config.bandwidth),
+                    double(_config.delay_mean), double(_config.delay_stddev),
+                    double(_config.delivery));
+                return;
+            }
+            sink.template add<Subnet>(name, std::string(name),
+                uint64_t(_config.seed), double(_config.delivery),
+                double(_config.delay_mean), double(_config.delay_stddev));
+        }
+
+        /**
+         * Function that adds the Subnets and the Repeaters of
+         * a channel and the couplings between them.
+        */
+        template<typename SINK>
+        void add_network_models(SINK &sink, unsigned k) const {
+            unsigned hops = _config.hops;
+
+            for (unsigned j = 0; j <= hops; j++) {
+                add_subnet(sink, subnet_name(k, 2 * j + 1));
+                add_subnet(sink, subnet_name(k, 2 * j + 2));
+                if (j == hops) {
+                    break;
+                }
+
+                /**
+                 * repeater j + 1 is between the subnets of
+                 * segment j and those of segment j + 1
+                */
+                std::string repeater = repeater_name(k, j + 1);
+                if (_config.buffered_repeaters) {
+                    sink.template add<BufferedRepeater>(repeater,
+                        std::string(repeater), uint64_t(_config.seed),
+                        repeater_buffer_config(_config.buffer));
+                }
+                else {
+                    sink.template add<Repeater>(repeater,
+                        seconds(_config.repeater_preparation));
+                }
+                sink.template couple<repeater_defs::ack_received_out,
+                    subnet_defs::in>(repeater, subnet_name(k, 2 * j + 2));
+                sink.template couple<subnet_defs::out,
+                    repeater_defs::packet_in>(subnet_name(k, 2 * j + 1),
+                                              repeater);
+                sink.template couple<repeater_defs::packet_sent_out,
+                    subnet_defs::in>(repeater, subnet_name(k, 2 * j + 3));
+                sink.template couple<subnet_defs::out,
+                    repeater_defs::ack_in>(subnet_name(k, 2 * j + 4),
+                                           repeater);
+            }
+        }
+
+        /**
+         * Function that builds the Network of a channel.
+        */
+        coupled_ptr make_network(unsigned k) const {
+            unsigned hops = _config.hops;
+            dynamic_model_sink<TIME> network;
+            add_network_models(network, k);
+
+            cadmium::dynamic::modeling::EICs eics_Network = {
+                cadmium::dynamic::translate::make_EIC<inp_1,
+                    subnet_defs::in>(subnet_name(k, 1)),
+                cadmium::dynamic::translate::make_EIC<inp_2,
+                    subnet_defs::in>(subnet_name(k, 2 * hops + 2))
+            };
+            cadmium::dynamic::modeling::EOCs eocs_Network = {
+                cadmium::dynamic::translate::make_EOC
+                    <subnet_defs::out,outp_1>(subnet_name(k, 2)),
+                cadmium::dynamic::translate::make_EOC
+                    <subnet_defs::out,outp_2>(subnet_name(k, 2 * hops + 1))
+            };
+            return std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(
+                coupled_name("Network", k),
+                network.models,
+                cadmium::dynamic::modeling::Ports{typeid(inp_1),typeid(inp_2)},
+                cadmium::dynamic::modeling::Ports{typeid(outp_1),typeid(outp_2)},
+                eics_Network,
+                eocs_Network,
+                network.ics
+            );
+        }
+
+        /**
+         * Function that adds the Sender, or the WindowSender,
+         * of a channel. The Sender queues the control messages
+         * received while active if queue_arrivals is true.
+        */
+        template<typename SINK>
+        void add_sender(SINK &sink, const std::string &sender,
+                        bool queue_arrivals) const {
+            if (_config.protocol == channel_protocol::abp) {
+                sink.template add<Sender>(sender,
+                    seconds(_config.sender_preparation),
+                    seconds(_config.timeout),
+                    bool(_config.adaptive_timeout), bool(queue_arrivals));
+                return;
+            }
+            sink.template add<WindowSender>(sender,
+                seconds(_config.sender_preparation),
+                seconds(_config.timeout), int(_config.window),
+                _config.window_seq_space(), _config.mode());
+        }
+
+        /**
+         * Function that adds the Receiver, or the WindowReceiver,
+         * of a channel.
+        */
+        template<typename SINK>
+        void add_receiver(SINK &sink, const std::string &receiver) const {
+            if (_config.protocol == channel_protocol::abp) {
+                sink.template add<Receiver>(receiver,
+                    seconds(_config.receiver_preparation));
+                return;
+            }
+            sink.template add<WindowReceiver>(receiver,
+                seconds(_config.receiver_preparation),
+                int(_config.window), _config.window_seq_space(),
+                _config.mode());
+        }
+
+        /**
+         * Function that adds the atomic models of a channel to the
+         * TOP model, with the couplings that the ABPSimulator and
+         * Network couplings of the channel would make.
+        */
+        template<typename GENERATOR_OUT, typename SINK>
+        void add_flat_channel(SINK &sink, unsigned k,
+                              const std::string &generator,
+                              bool queue_arrivals) const {
+            unsigned hops = _config.hops;
+            std::string sender = "sender" + std::to_string(k);
+            std::string receiver = "receiver" + std::to_string(k);
+
+            add_sender(sink, sender, queue_arrivals);
+            add_receiver(sink, receiver);
+            add_network_models(sink, k);
+
+            sink.template output<sender_defs::packet_sent_out,outp_pack>(
+                sender);
+            sink.template output<sender_defs::ack_received_out,outp_ack>(
+                sender);
+            sink.template couple<GENERATOR_OUT,sender_defs::control_in>(
+                generator, sender);
+            sink.template couple<sender_defs::data_out, subnet_defs::in>(
+                sender, subnet_name(k, 1));
+            sink.template couple<subnet_defs::out, sender_defs::ack_in>(
+                subnet_name(k, 2), sender);
+            sink.template couple<receiver_defs::out, subnet_defs::in>(
+                receiver, subnet_name(k, 2 * hops + 2));
+            sink.template couple<subnet_defs::out, receiver_defs::in>(
+                subnet_name(k, 2 * hops + 1), receiver);
+        }
+
+        /**
+         * Function that builds a channel: Sender, Receiver and Network.
+        */
+        coupled_ptr make_channel(unsigned k, bool queue_arrivals) const {
+            std::string sender = "sender" + std::to_string(k);
+            std::string receiver = "receiver" + std::to_string(k);
+            std::string network = coupled_name("Network", k);
+
+            dynamic_model_sink<TIME> channel;
+            add_sender(channel, sender, queue_arrivals);
+            add_receiver(channel, receiver);
+            channel.models.push_back(make_network(k));
+
+            cadmium::dynamic::modeling::EICs eics_ABPSimulator = {
+                cadmium::dynamic::translate::make_EIC<inp_control,
+                    sender_defs::control_in>(sender)
+            };
+            cadmium::dynamic::modeling::EOCs eocs_ABPSimulator = {
+                cadmium::dynamic::translate::make_EOC
+                    <sender_defs::packet_sent_out,outp_pack>(sender),
+                cadmium::dynamic::translate::make_EOC
+                    <sender_defs::ack_received_out,outp_ack>(sender)
+            };
+            cadmium::dynamic::modeling::ICs ics_ABPSimulator = {
+                cadmium::dynamic::translate::make_IC
+                    <sender_defs::data_out, inp_1>(sender, network),
+                cadmium::dynamic::translate::make_IC
+                    <outp_1, sender_defs::ack_in>(network, sender),
+                cadmium::dynamic::translate::make_IC
+                    <receiver_defs::out, inp_2>(receiver, network),
+                cadmium::dynamic::translate::make_IC
+                    <outp_2, receiver_defs::in>(network, receiver)
+            };
+            return std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(
+                coupled_name("ABPSimulator", k),
+                channel.models,
+                cadmium::dynamic::modeling::Ports{typeid(inp_control)},
+                cadmium::dynamic::modeling::Ports{typeid(outp_ack),
+                    typeid(outp_pack)},
+                eics_ABPSimulator,
+                eocs_ABPSimulator,
+                ics_ABPSimulator
+            );
+        }
+};
+
+#endif // __ABP_TOPOLOGY_HPP__
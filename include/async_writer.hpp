@@ -0,0 +1,124 @@
+/** \brief This header file declares the asynchronous log writer.
+ *
+ * The simulator thread writes the log into one of a ring of large
+ * buffers. A full buffer is handed to a dedicated I/O thread, which
+ * writes it to the file while the simulator fills the next buffer,
+ * so the simulator never waits on write(). The ring indices are
+ * atomics shared by exactly one producer and one consumer.
+ *
+ * When all buffers are waiting to be written, the writer either
+ * blocks until one is free or drops the complete lines of the
+ * current buffer and counts them, depending on the back-pressure
+ * policy. A buffer that holds no complete line to drop blocks.
+ * std::endl does not flush to the file: the log is written
+ * completely only by close().
+*/
+
+#ifndef __ASYNC_WRITER_HPP__
+#define __ASYNC_WRITER_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+#define ASYNC_BUFFERS 4
+#define ASYNC_BUFFER_SIZE (4 << 20)
+
+/**
+ * Policy used when all buffers are waiting to be written.
+*/
+enum class backpressure {
+    block,  //!< Wait until the I/O thread frees a buffer.
+    drop    //!< Drop the complete lines of the current buffer.
+};
+
+/**
+ * The async_streambuf class is the stream buffer of async_ofstream.
+*/
+class async_streambuf : public std::streambuf {
+    public:
+        /**
+         * Constructor that opens the file and starts the I/O thread.
+         * @param path file name string
+         * @param policy back-pressure policy
+         * @param buffers number of buffers in the ring, at least 2
+         * @param buffer_size size of every buffer in bytes
+        */
+        async_streambuf(const char *path, backpressure policy,
+                        size_t buffers, size_t buffer_size);
+        async_streambuf(const async_streambuf &) = delete;
+        async_streambuf &operator=(const async_streambuf &) = delete;
+        ~async_streambuf();
+
+        /**
+         * Function that hands the current buffer to the I/O thread,
+         * waits until everything is written and closes the file.
+        */
+        void close();
+
+        bool is_open() const { return _fd >= 0; }
+        uint64_t dropped_lines() const { return _dropped_lines; }
+        uint64_t dropped_bytes() const { return _dropped_bytes; }
+        uint64_t blocked() const { return _blocked; }
+
+    protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char *s, std::streamsize n) override;
+        int sync() override;
+
+    private:
+        bool next_buffer();
+        void publish();
+        void drop_lines();
+        void io_loop();
+
+        int _fd;
+        backpressure _policy;
+        std::vector<std::vector<char>> _buffers;
+        std::vector<size_t> _lengths;
+        std::atomic<uint64_t> _head;   //!< Buffers handed to the I/O thread.
+        std::atomic<uint64_t> _tail;   //!< Buffers written by the I/O thread.
+        std::atomic<bool> _closing;
+        char *_line_end;               //!< End of the last complete line.
+        char *_drop_from;              //!< Start of the lines that may be dropped.
+        bool _continued;               //!< First line started in the previous buffer.
+        uint64_t _dropped_lines;
+        uint64_t _dropped_bytes;
+        uint64_t _blocked;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::thread _io;
+};
+
+/**
+ * The async_ofstream class is an output stream that writes
+ * to a file through async_streambuf.
+*/
+class async_ofstream : public std::ostream {
+    public:
+        explicit async_ofstream(const char *path,
+                                backpressure policy = backpressure::block,
+                                size_t buffers = ASYNC_BUFFERS,
+                                size_t buffer_size = ASYNC_BUFFER_SIZE)
+            : std::ostream(nullptr),
+              _buf(path, policy, buffers, buffer_size) {
+            rdbuf(&_buf);
+        }
+
+        void close() { _buf.close(); }
+        bool is_open() const { return _buf.is_open(); }
+        uint64_t dropped_lines() const { return _buf.dropped_lines(); }
+        uint64_t dropped_bytes() const { return _buf.dropped_bytes(); }
+        uint64_t blocked() const { return _buf.blocked(); }
+
+    private:
+        async_streambuf _buf;
+};
+
+#endif // __ASYNC_WRITER_HPP__
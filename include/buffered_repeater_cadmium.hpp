@@ -0,0 +1,320 @@
+/** \brief This header file implements the BufferedRepeater class.
+ *
+ * The buffered repeater is a store and forward variant of the
+ * Repeater with the same ports. Packets and acknowledgements wait
+ * in a ring buffer of their own and are forwarded one at a time,
+ * each one after the service time of its direction from the start
+ * of its service, so inputs that arrive meanwhile neither replace
+ * the message in service nor delay it.
+ *
+ * A buffer holds at most capacity messages, the one in service
+ * included. A message that arrives to a full buffer is dropped
+ * (drop tail); with RED it may also be dropped earlier, with a
+ * probability that grows with the average occupancy between the
+ * two thresholds. The time weighted average occupancy and the drops
+ * of every buffer are written in the state log.
+*/
+
+#ifndef __BUFFERED_REPEATER_CADMIUM_HPP__
+#define __BUFFERED_REPEATER_CADMIUM_HPP__
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/message_bag.hpp>
+#include <limits>
+#include <math.h>
+#include <stdint.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "message.hpp"
+#include "counter_rng.hpp"
+#include "repeater_cadmium.hpp"
+#include "time_ticks.hpp"
+
+using namespace cadmium;
+using namespace std;
+
+/**
+ * Policy of a full or filling buffer.
+*/
+enum class queue_policy {
+    drop_tail,   //!< Drop the arrivals to a full buffer.
+    red          //!< Random early detection.
+};
+
+/**
+ * Structure that holds the constants of the buffers.
+*/
+struct repeater_buffer_config {
+    unsigned capacity = 16;        //!< Messages of a buffer at most.
+    double service_rate = 0.1;     //!< Messages forwarded per second.
+    queue_policy policy = queue_policy::drop_tail;
+    double red_min = 0.25;         //!< RED lower threshold, of capacity.
+    double red_max = 0.75;         //!< RED upper threshold, of capacity.
+    double red_max_p = 0.1;        //!< RED drop probability at red_max.
+    double red_weight = 0.002;     //!< RED weight of the average.
+};
+
+/**
+ * Structure that holds a ring buffer of messages
+ * and the statistics of its occupancy.
+*/
+struct repeater_buffer {
+    std::vector<Message_t> slots;   //!< Ring of capacity messages.
+    unsigned head = 0;        //!< Slot of the message in service.
+    unsigned size = 0;        //!< Messages in the buffer.
+    double red_average = 0;   //!< Average occupancy seen by RED.
+    double area = 0;          //!< Integral of the occupancy in ms.
+    uint64_t forwarded = 0;   //!< Messages forwarded.
+    uint64_t dropped = 0;     //!< Messages dropped when full.
+    uint64_t early_dropped = 0;   //!< Messages dropped by RED.
+
+    void push(const Message_t &message) {
+        slots[(head + size++) % slots.size()] = message;
+    }
+    const Message_t &front() const {
+        return slots[head];
+    }
+    void pop() {
+        head = (head + 1) % slots.size();
+        size--;
+    }
+};
+
+/**
+ * The BufferedRepeater class forwards messages
+ * through a buffer per direction.
+*/
+template<typename TIME>
+class BufferedRepeater {
+    // putting definitions in context
+    using defs = repeater_defs;
+public:
+    repeater_buffer_config CONFIG;   //!< Constants of the buffers.
+    TIME SERVICE_TIME;               //!< Time to forward a message.
+
+    /**
+     * Constructor for BufferedRepeater class with the default buffers,
+     * forwarding a message every 10 seconds as the Repeater. Every
+     * BufferedRepeater built this way draws the stream named repeater
+     * with run seed 0; one that needs a stream of its own is built
+     * with its name.
+    */
+    BufferedRepeater() noexcept :
+        BufferedRepeater("repeater", 0, repeater_buffer_config()) {
+    }
+
+    /**
+     * Constructor for BufferedRepeater class.
+     * @param name model name, selects the random stream of RED
+     * @param seed run seed
+     * @param config constants of the buffers
+    */
+    BufferedRepeater(const std::string &name, uint64_t seed,
+                     repeater_buffer_config config) noexcept {
+        assert(config.capacity > 0 && config.service_rate > 0 &&
+               "buffer of one message and positive rate at least");
+        CONFIG = config;
+        SERVICE_TIME = ticks_to_time<TIME>(llround(1000 /
+                                                   config.service_rate));
+        state.now = TIME();
+        state.since = TIME();
+        state.packets.slots.assign(config.capacity, Message_t());
+        state.acks.slots.assign(config.capacity, Message_t());
+        state.packet_done = std::numeric_limits<TIME>::infinity();
+        state.ack_done = std::numeric_limits<TIME>::infinity();
+        state.rng = counter_rng(seed, name);
+    }
+
+    /**
+     * Structure that holds the buffers and the end
+     * of the service of every direction.
+    */
+    struct state_type {
+        TIME now;                  //!< Time of the last transition.
+        TIME since;                //!< Time the areas were last updated.
+        repeater_buffer packets;   //!< Buffer towards the receiver.
+        repeater_buffer acks;      //!< Buffer towards the sender.
+        TIME packet_done;          //!< End of the packet in service.
+        TIME ack_done;             //!< End of the ack in service.
+        counter_rng rng;           //!< Random number stream of RED.
+    };
+    state_type state;
+
+    /**
+     * Defining input port and output port
+    */
+    using input_ports = std::tuple<typename defs::packet_in,
+        typename defs::ack_in>;
+    using output_ports = std::tuple<typename defs::packet_sent_out,
+        typename defs::ack_received_out>;
+
+    /**
+     * Internal transition function that removes the messages
+     * forwarded and starts the service of the next ones.
+    */
+    void internal_transition() {
+        TIME t = next_event();
+        advance(t);
+        if (state.packet_done == t) {
+            finish(state.packets, state.packet_done);
+        }
+        if (state.ack_done == t) {
+            finish(state.acks, state.ack_done);
+        }
+    }
+
+    /**
+     * Function that performs external transition.
+     * Every message is added to the buffer of its direction,
+     * unless the policy drops it.
+     * @param e time variable
+     * @param mbs message bags
+    */
+    void external_transition(TIME e,
+                             typename make_message_bags<input_ports>::type mbs) {
+        advance(state.now + e);
+        for (const auto &x : get_messages<typename defs::packet_in>(mbs)) {
+            arrive(state.packets, state.packet_done, x);
+        }
+        for (const auto &x : get_messages<typename defs::ack_in>(mbs)) {
+            arrive(state.acks, state.ack_done, x);
+        }
+    }
+
+    /**
+     * it is the function that make call to internal_transition
+     * followed by call to external transition.
+     * @param e time variable
+     * @param mbs message bags
+    */
+    void confluence_transition(TIME e,
+                               typename make_message_bags<input_ports>::type mbs) {
+        internal_transition();
+        external_transition(TIME(), std::move(mbs));
+    }
+
+    /**
+     * Funtion that sends the messages whose service
+     * ends now to the respective output ports.
+     * @return Message bags
+    */
+    typename make_message_bags<output_ports>::type output() const {
+        typename make_message_bags<output_ports>::type bags;
+        TIME t = next_event();
+        if (state.packet_done == t) {
+            get_messages<typename defs::packet_sent_out>(bags).push_back(
+                state.packets.front());
+        }
+        if (state.ack_done == t) {
+            get_messages<typename defs::ack_received_out>(bags).push_back(
+                state.acks.front());
+        }
+        return bags;
+    }
+
+    /**
+     * Function that returns the time until the next
+     * service ends, or infinity if the buffers are empty.
+     * @return Next internal time
+    */
+    TIME time_advance() const {
+        TIME t = next_event();
+        if (t == std::numeric_limits<TIME>::infinity()) {
+            return t;
+        }
+        return t - state.now;
+    }
+
+    /**
+     * Function that returns the time weighted average
+     * occupancy of a buffer up to the last transition.
+    */
+    double average_occupancy(const repeater_buffer &buffer) const {
+        double elapsed = (double) time_to_ticks(state.since);
+        return elapsed > 0 ? buffer.area / elapsed : 0;
+    }
+
+    /**
+     * Function that outputs the occupancy and the drops
+     * of the buffers to ostring stream
+     * @param os the ostring stream
+     * @param i  the structure state type
+     * @return os the ostring stream
+    */
+    friend std::ostringstream& operator<<(std::ostringstream& os,
+                                          const typename BufferedRepeater<TIME>::state_type& i) {
+        double elapsed = (double) time_to_ticks(i.since);
+        os << "packets: " << i.packets.size << " & packetDrops: "
+           << i.packets.dropped + i.packets.early_dropped
+           << " & avgPackets: " << (elapsed > 0 ? i.packets.area / elapsed : 0)
+           << " & acks: " << i.acks.size << " & ackDrops: "
+           << i.acks.dropped + i.acks.early_dropped
+           << " & avgAcks: " << (elapsed > 0 ? i.acks.area / elapsed : 0);
+        return os;
+    }
+
+private:
+    TIME next_event() const {
+        return state.ack_done < state.packet_done ?
+            state.ack_done : state.packet_done;
+    }
+
+    /**
+     * Function that moves the time to t and adds the
+     * occupancy since the last update to the areas.
+    */
+    void advance(TIME t) {
+        state.now = t;
+        if (state.packets.size == 0 && state.acks.size == 0) {
+            state.since = t;
+            return;
+        }
+        double elapsed = (double) time_to_ticks(t - state.since);
+        state.packets.area += state.packets.size * elapsed;
+        state.acks.area += state.acks.size * elapsed;
+        state.since = t;
+    }
+
+    /**
+     * Function that adds an arriving message to a buffer, or drops it.
+    */
+    void arrive(repeater_buffer &buffer, TIME &done, const Message_t &message) {
+        if (CONFIG.policy == queue_policy::red) {
+            buffer.red_average += CONFIG.red_weight *
+                (buffer.size - buffer.red_average);
+            double low = CONFIG.red_min * CONFIG.capacity;
+            double high = CONFIG.red_max * CONFIG.capacity;
+            if (buffer.red_average >= high ||
+                (buffer.red_average >= low && state.rng.uniform() <
+                    CONFIG.red_max_p * (buffer.red_average - low) /
+                        (high - low))) {
+                buffer.early_dropped++;
+                return;
+            }
+        }
+        if (buffer.size == buffer.slots.size()) {
+            buffer.dropped++;
+            return;
+        }
+        buffer.push(message);
+        if (buffer.size == 1) {
+            done = state.now + SERVICE_TIME;
+        }
+    }
+
+    /**
+     * Function that removes the message forwarded from
+     * a buffer and starts the service of the next one.
+    */
+    void finish(repeater_buffer &buffer, TIME &done) {
+        buffer.pop();
+        buffer.forwarded++;
+        done = buffer.size > 0 ? state.now + SERVICE_TIME :
+            std::numeric_limits<TIME>::infinity();
+    }
+};
+
+#endif // __BUFFERED_REPEATER_CADMIUM_HPP__
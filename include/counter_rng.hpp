@@ -0,0 +1,94 @@
+/** \brief This header file implements a counter based random number generator.
+ *
+ * Draw number n of a stream is a hash of the stream key and of n,
+ * computed with the SplitMix64 finalizer. A stream is therefore
+ * just a key and a counter: it is cheap to create and to copy, it
+ * shares nothing with other streams, and it gives the same numbers
+ * whichever thread draws them. The key is derived from a run seed
+ * and a stream name, such as the name of a model, so every model
+ * of a run has its own reproducible stream.
+*/
+
+#ifndef __COUNTER_RNG_HPP__
+#define __COUNTER_RNG_HPP__
+
+#include <math.h>
+#include <stdint.h>
+#include <limits>
+#include <string_view>
+
+/**
+ * The counter_rng class is a stream of random numbers.
+ * It meets the UniformRandomBitGenerator requirements, so it
+ * can also be used with the distributions of <random>.
+*/
+class counter_rng {
+    public:
+        using result_type = uint64_t;
+
+        counter_rng() noexcept : _key(mix(0)), _counter(0) {
+        }
+
+        /**
+         * Constructor that selects the stream of a name in a run.
+         * @param seed run seed
+         * @param name stream name
+        */
+        counter_rng(uint64_t seed, std::string_view name) noexcept :
+            _key(mix(seed ^ hash(name))), _counter(0) {
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        /** @return next 64 random bits */
+        result_type operator()() noexcept {
+            return mix(_key + 0x9E3779B97F4A7C15ULL * ++_counter);
+        }
+
+        /** @return next number uniform in [0, 1) */
+        double uniform() noexcept {
+            return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        /** @return next number of the normal distribution */
+        double normal(double mean, double stddev) noexcept {
+            /**
+             * Box-Muller transform; 1 - u is in (0, 1] so log is finite
+            */
+            double u = 1.0 - uniform();
+            double v = uniform();
+            return mean + stddev * sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+        }
+
+        /** @return number of draws made */
+        uint64_t counter() const noexcept { return _counter; }
+
+    private:
+        uint64_t _key;
+        uint64_t _counter;
+
+        /**
+         * SplitMix64 finalizer.
+        */
+        static constexpr uint64_t mix(uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * FNV-1a hash of the stream name.
+        */
+        static uint64_t hash(std::string_view name) {
+            uint64_t h = 0xCBF29CE484222325ULL;
+            for (unsigned char c : name) {
+                h = (h ^ c) * 0x100000001B3ULL;
+            }
+            return h;
+        }
+};
+
+#endif // __COUNTER_RNG_HPP__
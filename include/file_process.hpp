@@ -19,14 +19,56 @@
 #ifndef __FILE_PROCESS_HPP__
 #define __FILE_PROCESS_HPP__
 
+#include <cstddef>
+#include <string>
+
+#include "log_view.hpp"
+
 /** 
  * Function that gets the data from the input file
- * and writes the data in new format to the output file
+ * and writes the data in new format to the output file.
+ * The input file is mapped into memory and formatted without
+ * copying it. Files that can not be mapped are read in large
+ * blocks, so memory use does not depend on the size of the file.
  * @param fin input file name string
  * @param fout output file name string
 */
 void output_file_process(char *fin, char *fout);
 
+/** 
+ * Function that gets the data from the input file
+ * and writes the data in new format to the output file
+ * using several threads. The file is split into chunks
+ * that start on a Time line, every chunk is formatted
+ * on its own thread and the chunks are written in order,
+ * so the output is identical to output_file_process(fin, fout).
+ * @param fin input file name string
+ * @param fout output file name string
+ * @param threads number of threads, 0 uses all cores
+*/
+void output_file_process(char *fin, char *fout, unsigned threads);
+
+/** 
+ * Function that produces the same output as output_file_process
+ * by loading the whole input file and matching every line
+ * with regular expressions. Kept as the reference implementation.
+ * @param fin input file name string
+ * @param fout output file name string
+*/
+void output_file_process_regex(char *fin, char *fout);
+
+/** 
+ * Function that formats one line of the input file.
+ * A time line replaces the current time, a message line
+ * appends one table row per non empty port value.
+ * @param line first character of the line
+ * @param len length of the line without line terminator
+ * @param time current time, updated by time lines
+ * @param out string the table rows are appended to
+*/
+void format_line(const char *line, size_t len, std::string &time,
+                 std::string &out);
+
 /** 
  * Function that reads the input file into a string
  * in blocks of data.
@@ -44,5 +86,24 @@ char *read_file(char *fin);
 */
 void write_file(char *fout, char *file);
 
+/** 
+ * Function that outputs the data contained
+ * in the log view to the output file
+ * following specified format
+ * @param fout output file name string
+ * @param log view of the lines of the log
+*/
+void write_file(char *fout, const log_view &log);
+
+/** 
+ * Function that outputs the data contained
+ * in the mapped file to the output file
+ * following specified format. The pages of the
+ * file are released as soon as they are formatted.
+ * @param fout output file name string
+ * @param file mapped log file
+*/
+void write_file(char *fout, const mapped_file &file);
+
 
 #endif // __FILE_PROCESS_HPP__
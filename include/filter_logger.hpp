@@ -0,0 +1,120 @@
+/** \brief This header file declares the logger that drops empty message bags.
+ *
+ * Every model the runner consults is logged, also when it produced
+ * no output, as in "[] generated by model receiver1". These lines
+ * make up most of the log and write_file discards them anyway.
+ * nonempty_logger can be used in place of the logger of the
+ * logger_messages source. It recognizes empty bags from the logged
+ * parameters, before anything is formatted, and counts them.
+*/
+
+#ifndef __FILTER_LOGGER_HPP__
+#define __FILTER_LOGGER_HPP__
+
+#include <cadmium/logger/common_loggers.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "message.hpp"
+
+/**
+ * Function that checks if the text of a message bag has no messages,
+ * that is if it is "[]" or every port is followed by "{}".
+ * @param text message bag text, may be followed by the model name
+ * @return true if the bag is empty
+*/
+inline bool is_empty_bag_text(std::string_view text) {
+    if (text.empty() || text[0] != '[') {
+        return false;
+    }
+    size_t end = text.rfind(']');
+    if (end == std::string_view::npos) {
+        return false;
+    }
+    for (size_t i = text.find('{'); i < end; i = text.find('{', i + 1)) {
+        if (i + 1 >= text.size() || text[i + 1] != '}') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Text of a message bag as the runners of this repo log it. It is
+ * logged as the text, and also points to the messages, each with
+ * the index of its port, and to the port names, so loggers can read
+ * the messages instead of parsing the text. The pointers are valid
+ * while it is logged.
+*/
+struct message_bag_text : std::string {
+    const std::vector<std::pair<int, Message_t>> *messages = nullptr;
+    const std::vector<std::string> *ports = nullptr;
+};
+
+/**
+ * Function that checks if a logged parameter is the text of
+ * an empty message bag. Parameters of other types never are.
+*/
+template<typename PARAM>
+inline bool is_empty_bag_param(const PARAM &param) {
+    if constexpr (std::is_base_of<std::string, PARAM>::value) {
+        return is_empty_bag_text(param);
+    }
+    else {
+        return false;
+    }
+}
+
+/**
+ * Trait that tells if a logged parameter may be the text of a bag.
+*/
+template<typename PARAM>
+struct is_bag_text : std::is_base_of<std::string, PARAM> {
+};
+
+/**
+ * The nonempty_logger class is a logger that drops the messages
+ * log of models whose message bags are empty. It has the same
+ * parameters as cadmium::logger::logger, so it can be used in
+ * its place. If the bag is not passed as text, the line is
+ * formatted first and dropped if its bag is empty.
+*/
+template<typename LOGGING_SOURCE, typename FORMATTER, typename SINK_PROVIDER>
+struct nonempty_logger {
+    template<typename DECLARED_SOURCE, typename INFO, typename... PARAMs>
+    static void log(const PARAMs&... ps) {
+        if constexpr (std::is_same<LOGGING_SOURCE, DECLARED_SOURCE>::value) {
+            if constexpr ((is_bag_text<PARAMs>::value || ...)) {
+                if ((is_empty_bag_param(ps) || ...)) {
+                    suppressed()++;
+                    return;
+                }
+                cadmium::logger::logger<LOGGING_SOURCE, FORMATTER,
+                    SINK_PROVIDER>::template log<DECLARED_SOURCE, INFO>(ps...);
+            }
+            else {
+                std::string line = FORMATTER::template format<INFO>(ps...)();
+                if (is_empty_bag_text(line)) {
+                    suppressed()++;
+                    return;
+                }
+                SINK_PROVIDER::sink() << line << std::endl;
+            }
+        }
+    }
+
+    /**
+     * Function that returns the number of dropped empty bags.
+    */
+    static uint64_t &suppressed() {
+        static uint64_t count = 0;
+        return count;
+    }
+};
+
+#endif // __FILTER_LOGGER_HPP__
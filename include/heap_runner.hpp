@@ -0,0 +1,548 @@
+/** \brief This header file implements the heap_runner class.
+ *
+ * The heap runner simulates a flat coupled model, one level of
+ * atomic models coupled to one another directly, as abp_topology
+ * builds it with build_flat. It is a model sink: models are added
+ * with add, coupled with couple and connected to the TOP outputs
+ * with output.
+ *
+ * The next event time of every model is kept in an indexed binary
+ * heap. A step takes the models whose time is the smallest, the
+ * imminent models, from the top of the heap, collects their outputs,
+ * routes them to the models they are coupled to and runs the
+ * transitions of the imminent models and of the models that
+ * received messages. Only these models are visited, and only their
+ * times are updated in the heap, so a step costs O(a log n) for a
+ * active models out of n instead of the O(n) of visiting every
+ * model, and channels that are idle cost nothing.
+ *
+ * Within a step the models are visited in the order they were
+ * added, as the Cadmium runner visits the models of the flattened
+ * TOP model. The runner logs with the sources and parameters of the
+ * Cadmium runner, the global time of every step, the output of every
+ * imminent model and the state of every model after a transition,
+ * so the loggers of the Cadmium runner can be used as they are.
+ * Models with empty outputs are not logged, as the runner does not
+ * visit passive models; the log without empty message bags is that
+ * of the Cadmium runner.
+ *
+ * All ports must carry Message_t.
+*/
+
+#ifndef __HEAP_RUNNER_HPP__
+#define __HEAP_RUNNER_HPP__
+
+#include <cadmium/modeling/message_bag.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include <cxxabi.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <assert.h>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "filter_logger.hpp"
+#include "message.hpp"
+
+/**
+ * Messages of a model, each with the index of its port.
+*/
+using heap_messages = std::vector<std::pair<int, Message_t>>;
+
+/**
+ * Function that returns the name of a port type as the
+ * Cadmium loggers write it, as "sender_defs::data_out".
+*/
+inline std::string port_type_name(const std::type_info &type) {
+    int status = 0;
+    char *name = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    std::string result = status == 0 ? name : type.name();
+    free(name);
+    return result;
+}
+
+/**
+ * The heap_model class is the interface of the heap runner
+ * to an atomic model.
+*/
+template<typename TIME>
+class heap_model {
+    public:
+        explicit heap_model(std::string id) : _id(std::move(id)) {
+        }
+        virtual ~heap_model() {
+        }
+
+        const std::string &id() const { return _id; }
+
+        virtual TIME time_advance() const = 0;
+        virtual void internal_transition() = 0;
+        virtual void external_transition(TIME e,
+                                         const heap_messages &inbox) = 0;
+        virtual void confluence_transition(TIME e,
+                                           const heap_messages &inbox) = 0;
+        virtual void output(heap_messages &outbox) const = 0;
+
+        /** @return output as the Cadmium loggers write message bags */
+        virtual message_bag_text output_text(
+            const heap_messages &outbox) const = 0;
+        virtual std::string state_text() const = 0;
+
+        /** @return index of a port, -1 if the model has none of the type */
+        virtual int input_port(std::type_index port) const = 0;
+        virtual int output_port(std::type_index port) const = 0;
+
+    private:
+        std::string _id;
+};
+
+/**
+ * The heap_atomic class adapts an atomic model to heap_model, or to
+ * the BASE derived from it. It converts between the message bags of
+ * the model and the messages of the runner, with the index of every
+ * port in the port tuples.
+*/
+template<template<typename> class MODEL, typename TIME,
+         typename BASE = heap_model<TIME>>
+class heap_atomic : public BASE {
+    using model_type = MODEL<TIME>;
+    using input_ports = typename model_type::input_ports;
+    using output_ports = typename model_type::output_ports;
+    using input_bags =
+        typename cadmium::make_message_bags<input_ports>::type;
+    using output_bags =
+        typename cadmium::make_message_bags<output_ports>::type;
+    static constexpr size_t INPUTS = std::tuple_size<input_ports>::value;
+    static constexpr size_t OUTPUTS = std::tuple_size<output_ports>::value;
+
+    public:
+        template<typename... ARGS>
+        heap_atomic(std::string id, ARGS&&... args) :
+            BASE(std::move(id)),
+            _model(std::forward<ARGS>(args)...) {
+        }
+
+        TIME time_advance() const override {
+            return _model.time_advance();
+        }
+
+        void internal_transition() override {
+            _model.internal_transition();
+        }
+
+        void external_transition(TIME e, const heap_messages &inbox) override {
+            _model.external_transition(e, bags(inbox));
+        }
+
+        void confluence_transition(TIME e,
+                                   const heap_messages &inbox) override {
+            _model.confluence_transition(e, bags(inbox));
+        }
+
+        void output(heap_messages &outbox) const override {
+            output_bags out = _model.output();
+            collect(out, outbox, std::make_index_sequence<OUTPUTS>());
+        }
+
+        message_bag_text output_text(
+            const heap_messages &outbox) const override {
+            message_bag_text text;
+            text.messages = &outbox;
+            text.ports = &port_names();
+            if (outbox.empty()) {
+                text.assign("[]");
+                return text;
+            }
+            std::ostringstream os;
+            os << "[";
+            for (size_t p = 0; p < OUTPUTS; p++) {
+                os << (p ? ", " : "") << port_names()[p] << ": {";
+                bool first = true;
+                for (const auto &m : outbox) {
+                    if (m.first == (int) p) {
+                        os << (first ? "" : ", ") << m.second;
+                        first = false;
+                    }
+                }
+                os << "}";
+            }
+            os << "]";
+            text.assign(os.str());
+            return text;
+        }
+
+        std::string state_text() const override {
+            std::ostringstream os;
+            os << _model.state;
+            return os.str();
+        }
+
+        int input_port(std::type_index port) const override {
+            return index_of<input_ports>(port,
+                std::make_index_sequence<INPUTS>());
+        }
+
+        int output_port(std::type_index port) const override {
+            return index_of<output_ports>(port,
+                std::make_index_sequence<OUTPUTS>());
+        }
+
+    protected:
+        model_type _model;
+
+    private:
+        input_bags bags(const heap_messages &inbox) const {
+            input_bags in;
+            for (const auto &m : inbox) {
+                push(in, m.first, m.second,
+                     std::make_index_sequence<INPUTS>());
+            }
+            return in;
+        }
+
+        template<size_t... I>
+        static void push(input_bags &in, int port, const Message_t &message,
+                         std::index_sequence<I...>) {
+            ((port == (int) I ? (void) cadmium::get_messages
+                <std::tuple_element_t<I, input_ports>>(in).push_back(message) :
+                (void) 0), ...);
+        }
+
+        template<size_t... I>
+        static void collect(output_bags &out, heap_messages &outbox,
+                            std::index_sequence<I...>) {
+            (append<I>(out, outbox), ...);
+        }
+
+        template<size_t I>
+        static void append(output_bags &out, heap_messages &outbox) {
+            for (const auto &message : cadmium::get_messages
+                <std::tuple_element_t<I, output_ports>>(out)) {
+                outbox.emplace_back((int) I, message);
+            }
+        }
+
+        template<typename PORTS, size_t... I>
+        static int index_of([[maybe_unused]] std::type_index port,
+                            std::index_sequence<I...>) {
+            int index = -1;
+            ((port == std::type_index(typeid(std::tuple_element_t<I, PORTS>)) ?
+                (void) (index = (int) I) : (void) 0), ...);
+            return index;
+        }
+
+        static const std::vector<std::string> &port_names() {
+            static const std::vector<std::string> names =
+                names_of(std::make_index_sequence<OUTPUTS>());
+            return names;
+        }
+
+        template<size_t... I>
+        static std::vector<std::string> names_of(std::index_sequence<I...>) {
+            return {port_type_name(typeid(
+                std::tuple_element_t<I, output_ports>))...};
+        }
+};
+
+/**
+ * The event_heap class is a binary heap of the next event times of
+ * the models that also keeps the position of every model in it, so
+ * the time of any model is changed in O(log n). Models with equal
+ * times are ordered by their index.
+*/
+template<typename TIME>
+class event_heap {
+    public:
+        /**
+         * Function that adds a model with the next index.
+        */
+        void push(TIME time) {
+            size_t model = _time.size();
+            _time.push_back(time);
+            _position.push_back(_heap.size());
+            _heap.push_back(model);
+            up(_heap.size() - 1);
+        }
+
+        /**
+         * Function that changes the next event time of a model.
+        */
+        void update(size_t model, TIME time) {
+            _time[model] = time;
+            up(_position[model]);
+            down(_position[model]);
+        }
+
+        bool empty() const { return _heap.empty(); }
+        TIME top_time() const { return _time[_heap[0]]; }
+        TIME time(size_t model) const { return _time[model]; }
+
+        /**
+         * Function that appends the models whose next event time
+         * is t, the smallest time. They are a subtree at the top.
+        */
+        void imminent(TIME t, std::vector<size_t> &models) const {
+            if (_heap.empty() || !(_time[_heap[0]] == t)) {
+                return;
+            }
+            size_t first = models.size();
+            models.push_back(_heap[0]);
+            for (size_t i = first; i < models.size(); i++) {
+                size_t p = _position[models[i]];
+                for (size_t c = 2 * p + 1; c <= 2 * p + 2 &&
+                     c < _heap.size(); c++) {
+                    if (_time[_heap[c]] == t) {
+                        models.push_back(_heap[c]);
+                    }
+                }
+            }
+        }
+
+    private:
+        std::vector<size_t> _heap;       //!< Models, ordered as a heap.
+        std::vector<size_t> _position;   //!< Position of every model.
+        std::vector<TIME> _time;         //!< Next event of every model.
+
+        bool before(size_t a, size_t b) const {
+            return _time[a] < _time[b] || (_time[a] == _time[b] && a < b);
+        }
+
+        void swap_at(size_t i, size_t j) {
+            std::swap(_heap[i], _heap[j]);
+            _position[_heap[i]] = i;
+            _position[_heap[j]] = j;
+        }
+
+        void up(size_t i) {
+            while (i > 0 && before(_heap[i], _heap[(i - 1) / 2])) {
+                swap_at(i, (i - 1) / 2);
+                i = (i - 1) / 2;
+            }
+        }
+
+        void down(size_t i) {
+            for (;;) {
+                size_t best = i;
+                for (size_t c = 2 * i + 1; c <= 2 * i + 2 &&
+                     c < _heap.size(); c++) {
+                    if (before(_heap[c], _heap[best])) {
+                        best = c;
+                    }
+                }
+                if (best == i) {
+                    return;
+                }
+                swap_at(i, best);
+                i = best;
+            }
+        }
+};
+
+/**
+ * The heap_runner class simulates a flat coupled model,
+ * visiting only the models with events.
+*/
+template<typename TIME, typename LOGGER>
+class heap_runner {
+    public:
+        /**
+         * Function that adds an atomic model.
+         * @param name model name
+         * @param args arguments of the constructor of the model
+        */
+        template<template<typename> class MODEL, typename... ARGS>
+        void add(const std::string &name, ARGS... args) {
+            assert(!_started && "models are added before the run");
+            _index.emplace(name, _models.size());
+            _models.push_back(std::make_unique<heap_atomic<MODEL, TIME>>(
+                name, std::move(args)...));
+            _routes.emplace_back();
+        }
+
+        /**
+         * Function that couples an output port of a model to an
+         * input port of another one. The models may be added later,
+         * the couplings are resolved when the simulation starts.
+        */
+        template<typename FROM_PORT, typename TO_PORT>
+        void couple(const std::string &from, const std::string &to) {
+            assert(!_started && "models are coupled before the run");
+            _couplings.push_back({from, to, typeid(FROM_PORT),
+                                  typeid(TO_PORT)});
+        }
+
+        /**
+         * Function that connects an output port of a model to an
+         * output port of the TOP model. The outputs of the TOP
+         * model go nowhere; they are logged with the model.
+        */
+        template<typename FROM_PORT, typename TO_PORT>
+        void output(const std::string &) {
+        }
+
+        /** @return number of models */
+        size_t models() const { return _models.size(); }
+
+        /**
+         * Function that starts the simulation at the initial time.
+         * @param initial_time time of the start
+        */
+        void start(const TIME &initial_time) {
+            _started = true;
+            for (const coupling &c : _couplings) {
+                size_t source = model_index(c.from);
+                size_t destination = model_index(c.to);
+                int out = _models[source]->output_port(c.from_port);
+                int in = _models[destination]->input_port(c.to_port);
+                assert(out >= 0 && in >= 0 && "port of the model");
+                if ((size_t) out >= _routes[source].size()) {
+                    _routes[source].resize(out + 1);
+                }
+                _routes[source][out].emplace_back(destination, in);
+            }
+            _couplings.clear();
+            _inbox.assign(_models.size(), heap_messages());
+            _last.assign(_models.size(), initial_time);
+            _is_imminent.assign(_models.size(), false);
+            LOGGER::template log<cadmium::logger::logger_global_time,
+                cadmium::logger::run_global_time>(initial_time);
+            for (size_t m = 0; m < _models.size(); m++) {
+                LOGGER::template log<cadmium::logger::logger_state,
+                    cadmium::logger::sim_state>(initial_time,
+                        _models[m]->id(), _models[m]->state_text());
+                _events.push(next_time(initial_time,
+                                       _models[m]->time_advance()));
+            }
+        }
+
+        /** @return time of the next event */
+        TIME next_event() const {
+            return _events.empty() ? std::numeric_limits<TIME>::infinity() :
+                _events.top_time();
+        }
+
+        /**
+         * Function that simulates the events before time t.
+         * @param t time to simulate until
+         * @return time of the next event
+        */
+        TIME run_until(const TIME &t) {
+            if (!_started) {
+                start(TIME());
+            }
+            while (!_events.empty() && _events.top_time() < t) {
+                step(_events.top_time());
+            }
+            return next_event();
+        }
+
+    private:
+        using route = std::pair<size_t, int>;   //!< Model and input port.
+
+        /**
+         * Structure that holds a coupling until the models are known.
+        */
+        struct coupling {
+            std::string from;
+            std::string to;
+            std::type_index from_port;
+            std::type_index to_port;
+        };
+
+        std::vector<coupling> _couplings;
+
+        std::vector<std::unique_ptr<heap_model<TIME>>> _models;
+        std::unordered_map<std::string, size_t> _index;
+        std::vector<std::vector<std::vector<route>>> _routes;
+        std::vector<heap_messages> _inbox;   //!< Inputs of the step.
+        std::vector<TIME> _last;             //!< Time of the last transition.
+        std::vector<bool> _is_imminent;      //!< Model is imminent in the step.
+        event_heap<TIME> _events;
+        std::vector<size_t> _imminent;
+        std::vector<size_t> _active;
+        heap_messages _outbox;
+        bool _started = false;
+
+        size_t model_index(const std::string &name) const {
+            auto it = _index.find(name);
+            assert(it != _index.end() && "coupled model added");
+            return it->second;
+        }
+
+        static TIME next_time(const TIME &t, const TIME &advance) {
+            return advance == std::numeric_limits<TIME>::infinity() ?
+                advance : t + advance;
+        }
+
+        /**
+         * Function that simulates the events at time t.
+        */
+        void step(TIME t) {
+            LOGGER::template log<cadmium::logger::logger_global_time,
+                cadmium::logger::run_global_time>(t);
+            _imminent.clear();
+            _events.imminent(t, _imminent);
+            std::sort(_imminent.begin(), _imminent.end());
+            _active.assign(_imminent.begin(), _imminent.end());
+
+            for (size_t m : _imminent) {
+                _outbox.clear();
+                _models[m]->output(_outbox);
+                if (_outbox.empty()) {
+                    continue;
+                }
+                LOGGER::template log<cadmium::logger::logger_messages,
+                    cadmium::logger::sim_messages_collect>(t,
+                        _models[m]->id(), _models[m]->output_text(_outbox));
+                for (const auto &message : _outbox) {
+                    if ((size_t) message.first >= _routes[m].size()) {
+                        continue;
+                    }
+                    for (const route &r : _routes[m][message.first]) {
+                        if (_inbox[r.first].empty()) {
+                            _active.push_back(r.first);
+                        }
+                        _inbox[r.first].emplace_back(r.second, message.second);
+                    }
+                }
+            }
+
+            std::sort(_active.begin(), _active.end());
+            _active.erase(std::unique(_active.begin(), _active.end()),
+                          _active.end());
+            for (size_t m : _imminent) {
+                _is_imminent[m] = true;
+            }
+            for (size_t m : _active) {
+                TIME e = t - _last[m];
+                if (!_is_imminent[m]) {
+                    _models[m]->external_transition(e, _inbox[m]);
+                }
+                else if (_inbox[m].empty()) {
+                    _models[m]->internal_transition();
+                }
+                else {
+                    _models[m]->confluence_transition(e, _inbox[m]);
+                }
+                _is_imminent[m] = false;
+                _inbox[m].clear();
+                _last[m] = t;
+                LOGGER::template log<cadmium::logger::logger_state,
+                    cadmium::logger::sim_state>(t, _models[m]->id(),
+                        _models[m]->state_text());
+                _events.update(m, next_time(t, _models[m]->time_advance()));
+            }
+        }
+};
+
+#endif // __HEAP_RUNNER_HPP__
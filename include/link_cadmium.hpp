@@ -0,0 +1,210 @@
+/** \brief This header file implements the Link class.
+ *
+ * The link is a variant of the Subnet with the same ports that
+ * carries any number of messages at once. Every message is first
+ * transmitted, one after another, at the bandwidth of the link,
+ * and then arrives after the propagation delay plus a jitter
+ * drawn from the normal distribution, never below zero, unless it
+ * is lost. Messages may arrive in another order than they were
+ * sent when the jitter is larger than the transmission time.
+ *
+ * The messages in flight are kept in a binary heap ordered by
+ * their arrival time, so a message is inserted in O(log n) and
+ * the time advance reads the top of the heap in O(1). Messages
+ * leave one at a time, those arriving together at the same time
+ * one after another, so the next model gets one message per bag.
+*/
+
+#ifndef __LINK_CADMIUM_HPP__
+#define __LINK_CADMIUM_HPP__
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/message_bag.hpp>
+#include <limits>
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "message.hpp"
+#include "counter_rng.hpp"
+#include "subnet_cadmium.hpp"
+#include "time_ticks.hpp"
+
+using namespace cadmium;
+using namespace std;
+
+/**
+ * The Link class receives messages and transmits
+ * them out with a queueing and propagation delay.
+*/
+template<typename TIME>
+class Link {
+    /*putting definitions in context*/
+    using defs = subnet_defs;
+    public:
+        double BANDWIDTH;             //!< Messages per second, 0 unlimited.
+        double PROPAGATION_DELAY;     //!< Mean delay in seconds.
+        double JITTER;                //!< Standard deviation of the delay.
+        double DELIVERY_PROBABILITY;  //!< Probability of delivering.
+
+        /**
+         * Constructor for Link class with the delay and
+         * loss of the Subnet and unlimited bandwidth. Every Link
+         * built this way draws the stream named link with run
+         * seed 0; a Link that needs a stream of its own is built
+         * with its name.
+        */
+        Link() noexcept : Link("link", 0, 0, 3.0, 1.0, 0.95) {
+        }
+
+        /**
+         * Constructor for Link class.
+         * @param name model name, selects the random stream
+         * @param seed run seed
+         * @param bandwidth messages per second, 0 for unlimited
+         * @param propagation_delay mean delay in seconds
+         * @param jitter standard deviation of the delay in seconds
+         * @param delivery_probability probability of delivering
+        */
+        Link(const std::string &name, uint64_t seed, double bandwidth,
+             double propagation_delay, double jitter,
+             double delivery_probability) noexcept {
+            BANDWIDTH             = bandwidth;
+            PROPAGATION_DELAY     = propagation_delay;
+            JITTER                = jitter;
+            DELIVERY_PROBABILITY  = delivery_probability;
+            state.now             = TIME();
+            state.transmitter_free = 0;
+            state.sequence        = 0;
+            state.lost            = 0;
+            state.rng             = counter_rng(seed, name);
+        }
+
+        /**
+         * Structure that holds a message in flight.
+         * Messages that arrive at the same time keep their order.
+        */
+        struct flight_type {
+            TIME arrival;        //!< Time the message leaves the link.
+            uint64_t sequence;   //!< Order of the message in the link.
+            Message_t message;
+
+            bool operator>(const flight_type &o) const {
+                return o.arrival < arrival ||
+                    (arrival == o.arrival && sequence > o.sequence);
+            }
+        };
+
+        /**
+         * Structure that holds the state variables.
+        */
+        struct state_type {
+            TIME now;                //!< Time of the last transition.
+            double transmitter_free; //!< End of the last transmission in ms.
+            uint64_t sequence;       //!< Messages received.
+            uint64_t lost;           //!< Messages lost.
+            counter_rng rng;         //!< Random number stream of the link.
+            std::priority_queue<flight_type, std::vector<flight_type>,
+                std::greater<flight_type>> in_flight;
+        };
+        state_type state;
+
+        // ports definition to initialize input and output ports
+        using input_ports = std::tuple<typename defs::in>;
+        using output_ports = std::tuple<typename defs::out>;
+
+        /**
+         * Function that performs the internal transition.
+         * It removes the message that left the link.
+        */
+        void internal_transition() {
+            state.now = state.in_flight.top().arrival;
+            state.in_flight.pop();
+        }
+
+        /**
+         * Function that performs external transition.
+         * Every message waits for the transmitter, is transmitted
+         * and, unless it is lost, is put in flight with its arrival
+         * time. Any number of messages is accepted at a time. The
+         * transmissions are timed exactly and only the arrival
+         * times are rounded to milliseconds.
+         * @param e time variable
+         * @param mbs message bags
+        */
+        void external_transition(TIME e,
+            typename make_message_bags<input_ports>::type mbs) {
+            state.now = state.now + e;
+            double now = (double) time_to_ticks(state.now);
+            for (const auto &x : get_messages<typename defs::in>(mbs)) {
+                double start = max(now, state.transmitter_free);
+                state.transmitter_free = BANDWIDTH > 0 ?
+                    start + 1000 / BANDWIDTH : start;
+                double delay = max(0.0, state.rng.normal(PROPAGATION_DELAY,
+                                                         JITTER));
+                if (state.rng.uniform() >= DELIVERY_PROBABILITY) {
+                    state.lost++;
+                    continue;
+                }
+                state.in_flight.push({ticks_to_time<TIME>(
+                    llround(state.transmitter_free + delay * 1000)),
+                    state.sequence++, x});
+            }
+        }
+
+        /**
+         * This function calls the internal transition function
+         * followed by external transition function
+         * @param e time variable
+         * @param mbs message bags
+        */
+        void confluence_transition(TIME e,
+            typename make_message_bags<input_ports>::type mbs) {
+            internal_transition();
+            external_transition(TIME(), std::move(mbs));
+        }
+
+        /**
+         * Function that sends the message that
+         * leaves the link first to the output port.
+         * @return message bags
+        */
+        typename make_message_bags<output_ports>::type output() const {
+            typename make_message_bags<output_ports>::type bags;
+            get_messages<typename defs::out>(bags).push_back(
+                state.in_flight.top().message);
+            return bags;
+        }
+
+        /**
+         * Function that returns the time until the
+         * next message leaves the link, or infinity.
+         * @return next internal time
+        */
+        TIME time_advance() const {
+            if (state.in_flight.empty()) {
+                return std::numeric_limits<TIME>::infinity();
+            }
+            return state.in_flight.top().arrival - state.now;
+        }
+
+        /**
+         * Function that transmits the message to the ostring stream
+         * @param os ostring stream
+         * @param i state type
+         * @return os ostring stream
+         */
+        friend std::ostringstream& operator<<(std::ostringstream& os,
+            const typename Link<TIME>::state_type& i) {
+            os << "in_flight: " << i.in_flight.size() << " & lost: " << i.lost;
+            return os;
+        }
+};
+
+#endif // __LINK_CADMIUM_HPP__
@@ -0,0 +1,132 @@
+/** \brief This header file declares classes for reading simulator logs
+ * without copying them.
+ *
+ * A mapped_file maps a whole file read only into memory and
+ * tells the kernel that it is going to be read sequentially,
+ * so pages are read ahead and dropped behind the reader.
+ * A log_view is a range of mapped memory that hands out the
+ * lines of the log as std::string_view, pointing straight
+ * into the mapped pages. Empty lines are skipped and both
+ * "\n" and "\r" end a line, the same as strtok(file, "\r\n").
+*/
+
+#ifndef __LOG_VIEW_HPP__
+#define __LOG_VIEW_HPP__
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+/**
+ * The mapped_file class maps a file read only into memory.
+*/
+class mapped_file {
+    public:
+        mapped_file() noexcept;
+
+        /**
+         * Constructor that maps the file.
+         * @param path file name string
+        */
+        explicit mapped_file(const char *path) noexcept;
+
+        mapped_file(const mapped_file &) = delete;
+        mapped_file &operator=(const mapped_file &) = delete;
+        mapped_file(mapped_file &&other) noexcept;
+        mapped_file &operator=(mapped_file &&other) noexcept;
+        ~mapped_file();
+
+        /**
+         * Function that maps the file, unmapping the previous one.
+         * Files that can not be mapped, such as pipes and
+         * empty files, leave the object closed.
+         * @param path file name string
+         * @return true if the file is mapped
+        */
+        bool open(const char *path) noexcept;
+
+        /**
+         * Function that unmaps the file.
+        */
+        void close() noexcept;
+
+        bool is_open() const noexcept { return _data != nullptr; }
+        const char *data() const noexcept { return _data; }
+        size_t size() const noexcept { return _size; }
+
+        /**
+         * Function that tells the kernel that the pages before
+         * the given offset are not needed any more. The pages
+         * stay in the page cache but leave the resident set.
+         * @param offset offset of the first byte still needed
+        */
+        void release(size_t offset) const noexcept;
+
+    private:
+        const char *_data;
+        size_t _size;
+};
+
+/**
+ * The log_view class is a range of lines in mapped memory.
+*/
+class log_view {
+    public:
+        /**
+         * Iterator over the non empty lines of the range.
+        */
+        class iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::string_view;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const std::string_view *;
+                using reference = const std::string_view &;
+
+                iterator() noexcept : _end(nullptr) {}
+                iterator(const char *begin, const char *end) noexcept;
+
+                reference operator*() const noexcept { return _line; }
+                pointer operator->() const noexcept { return &_line; }
+                iterator &operator++() noexcept;
+                iterator operator++(int) noexcept {
+                    iterator tmp = *this;
+                    ++*this;
+                    return tmp;
+                }
+                bool operator==(const iterator &other) const noexcept {
+                    return _line.data() == other._line.data();
+                }
+                bool operator!=(const iterator &other) const noexcept {
+                    return !(*this == other);
+                }
+
+            private:
+                void find_line(const char *from) noexcept;
+
+                std::string_view _line;
+                const char *_end;
+        };
+
+        log_view() noexcept : _data(nullptr), _size(0) {}
+        log_view(const char *data, size_t size) noexcept
+            : _data(data), _size(size) {}
+        explicit log_view(const mapped_file &file) noexcept
+            : _data(file.data()), _size(file.size()) {}
+
+        const char *data() const noexcept { return _data; }
+        size_t size() const noexcept { return _size; }
+
+        iterator begin() const noexcept {
+            return iterator(_data, _data + _size);
+        }
+        iterator end() const noexcept {
+            return iterator(_data + _size, _data + _size);
+        }
+
+    private:
+        const char *_data;
+        size_t _size;
+};
+
+#endif // __LOG_VIEW_HPP__
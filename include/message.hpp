@@ -2,29 +2,106 @@
 #define BOOST_SIMULATION_MESSAGE_HPP
 
 #include <assert.h>
+#include <stdint.h>
 #include <iostream>
 #include <string>
 
 using namespace std;
 
+/**
+ * Kind of a message, which tells the fields it uses.
+*/
+enum class message_kind : uint8_t {
+    number = 0,   //!< A number in seq: packets to send, packet number
+                  //!< or sequence number.
+    data = 1,     //!< A packet: packet number and alternating bit.
+    ack = 2       //!< An acknowledgement: alternating bit.
+};
+
 /*******************************************/
 /**************** Message_t ****************/
 /*******************************************/
+/**
+ * Packed message of 8 bytes with explicit fields. The old messages
+ * held a single float, with packets encoded as packet * 10 + bit;
+ * the stream operators keep that text form, so inputs and logs are
+ * unchanged: a data message is written as seq * 10 + bit, an
+ * acknowledgement as its bit and a number as itself.
+*/
 struct Message_t {
-    Message_t(){}
-    Message_t(float i_value)
-    :value(i_value){}
+    uint32_t seq;          //!< Packet, sequence or control number.
+    uint16_t session;      //!< Session of the message.
+    uint16_t length : 12;  //!< Payload length in bytes.
+    uint16_t kind : 3;     //!< message_kind of the message.
+    uint16_t bit : 1;      //!< Alternating bit.
+
+    Message_t() : seq(0), session(0), length(0), kind(0), bit(0) {}
+
+    /**
+     * Constructor from the old value, used to read inputs.
+     * The value is kept as a number whose bit is its last digit
+     * modulo 2, so it serves as a count, a packet or an ack.
+    */
+    explicit Message_t(uint32_t legacy)
+    :Message_t() {
+        seq = legacy;
+        bit = seq % 10 % 2;
+    }
+
+    /** @return message holding a number */
+    static Message_t number(uint32_t n, uint16_t session = 0) {
+        Message_t m;
+        m.seq = n;
+        m.session = session;
+        return m;
+    }
 
-  	float   value;
+    /** @return packet with its alternating bit */
+    static Message_t data(uint32_t packet, int alt_bit,
+                          uint16_t session = 0) {
+        Message_t m;
+        m.seq = packet;
+        m.bit = alt_bit;
+        m.session = session;
+        m.kind = static_cast<uint16_t>(message_kind::data);
+        return m;
+    }
+
+    /** @return acknowledgement of an alternating bit */
+    static Message_t ack(int alt_bit, uint16_t session = 0) {
+        Message_t m;
+        m.bit = alt_bit;
+        m.session = session;
+        m.kind = static_cast<uint16_t>(message_kind::ack);
+        return m;
+    }
+
+    message_kind type() const {
+        return static_cast<message_kind>(kind);
+    }
+
+    /** @return value of the message in the old float encoding */
+    int64_t legacy_value() const {
+        switch (type()) {
+            case message_kind::data:
+                return (int64_t) seq * 10 + bit;
+            case message_kind::ack:
+                return bit;
+            default:
+                return seq;
+        }
+    }
 
     void clear() {
-        Message_t(); 
+        *this = Message_t();
     }
 };
 
+static_assert(sizeof(Message_t) == 8, "Message_t is packed in 8 bytes");
+
 istream& operator>> (istream& is, Message_t& msg);
 
 ostream& operator<<(ostream& os, const Message_t& msg);
 
 
-#endif // BOOST_SIMULATION_MESSAGE_HPP
\ No newline at end of file
+#endif // BOOST_SIMULATION_MESSAGE_HPP
@@ -0,0 +1,571 @@
+/** \brief This header file implements the parallel_runner class.
+ *
+ * The parallel runner simulates a flat coupled model, as the heap
+ * runner does, with several threads. It is a model sink like the
+ * heap runner: models are added with add, coupled with couple and
+ * connected to the TOP outputs with output.
+ *
+ * When the simulation starts the models are split into the groups
+ * that are coupled to one another, the connected components of the
+ * couplings. The ABP channels with a generator each share no model
+ * and no coupling, so every channel is a component. The components
+ * are dealt to one partition per thread, the largest first to the
+ * partition with the fewest models, and every partition is a heap
+ * runner of its own.
+ *
+ * No message crosses from one partition to another, so a partition
+ * never has to wait for an input from another one and the lookahead
+ * between partitions is unbounded. The partitions are still run in
+ * conservative time windows: a window starts at the earliest next
+ * event of all partitions and is the given width long, every thread
+ * simulates the events of its partition in the window, and then the
+ * threads wait for one another. The logs of the window are kept by
+ * the partitions and are merged by the calling thread at the end of
+ * the window, so the width only bounds the records that are kept.
+ * At every time the global time is logged once, then the outputs of
+ * the models of all partitions and then their states, in the order
+ * the models were added, as the heap runner logs them. The log, and
+ * so every event, is the same as that of the heap runner with any
+ * number of threads.
+ *
+ * A topology with one generator for all channels is one component,
+ * and is simulated by one thread.
+*/
+
+#ifndef __PARALLEL_RUNNER_HPP__
+#define __PARALLEL_RUNNER_HPP__
+
+#include <cadmium/logger/common_loggers.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <assert.h>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "heap_runner.hpp"
+
+/**
+ * Kind of a log record of a partition.
+*/
+enum class window_record_kind {
+    global_time,   //!< Start of the events at a time.
+    messages,      //!< Output of a model.
+    state          //!< State of a model after a transition.
+};
+
+/**
+ * Structure that holds a log record of a partition.
+*/
+template<typename TIME>
+struct window_record {
+    window_record_kind kind;
+    TIME time;
+    size_t model;       //!< Index of the model in the parallel runner.
+    std::string text;   //!< Output or state as the loggers write it.
+};
+
+/**
+ * Structure that holds the log records of a partition in a window.
+*/
+template<typename TIME>
+struct window_log {
+    std::vector<window_record<TIME>> records;
+    const std::unordered_map<std::string, size_t> *index = nullptr;
+
+    void time(const TIME &t) {
+        records.push_back({window_record_kind::global_time, t, 0,
+                           std::string()});
+    }
+
+    void model(window_record_kind kind, const TIME &t, const std::string &id,
+               const std::string &text) {
+        records.push_back({kind, t, index->at(id), text});
+    }
+
+    void model(window_record_kind kind, const TIME &t, size_t model,
+               std::string text) {
+        records.push_back({kind, t, model, std::move(text)});
+    }
+};
+
+/**
+ * Logger of the partitions, which keeps the records in the
+ * window log of the partition that the thread simulates.
+*/
+template<typename TIME>
+struct window_logger {
+    static thread_local window_log<TIME> *current;
+
+    template<typename DECLARED_SOURCE, typename INFO, typename... PARAMs>
+    static void log(const PARAMs&... ps) {
+        if constexpr (sizeof...(PARAMs) == 1) {
+            current->time(ps...);
+        }
+        else if constexpr (std::is_same<DECLARED_SOURCE,
+            cadmium::logger::logger_messages>::value) {
+            current->model(window_record_kind::messages, ps...);
+        }
+        else if constexpr (std::is_same<DECLARED_SOURCE,
+            cadmium::logger::logger_state>::value) {
+            current->model(window_record_kind::state, ps...);
+        }
+    }
+};
+
+template<typename TIME>
+thread_local window_log<TIME> *window_logger<TIME>::current = nullptr;
+
+/**
+ * The window_merger class logs the records of the partitions as the
+ * heap runner logs them: at every time the global time once, then
+ * the outputs of the models of all partitions and then their states,
+ * in the order the models were added.
+*/
+template<typename TIME, typename LOGGER>
+class window_merger {
+    public:
+        explicit window_merger(const std::vector<std::string> &names) :
+            _names(names) {
+        }
+
+        /**
+         * Function that logs the first ends[p] records of log p,
+         * which are whole steps, and erases them.
+        */
+        void merge(const std::vector<window_log<TIME> *> &logs,
+                   const std::vector<size_t> &ends) {
+            _next.assign(logs.size(), 0);
+            for (;;) {
+                const window_record<TIME> *first = nullptr;
+                for (size_t p = 0; p < logs.size(); p++) {
+                    if (_next[p] < ends[p] && (!first ||
+                        logs[p]->records[_next[p]].time < first->time)) {
+                        first = &logs[p]->records[_next[p]];
+                    }
+                }
+                if (!first) {
+                    break;
+                }
+                TIME t = first->time;
+                LOGGER::template log<cadmium::logger::logger_global_time,
+                    cadmium::logger::run_global_time>(t);
+
+                _step.clear();
+                for (size_t p = 0; p < logs.size(); p++) {
+                    const std::vector<window_record<TIME>> &records =
+                        logs[p]->records;
+                    size_t &r = _next[p];
+                    if (r == ends[p] || !(records[r].time == t)) {
+                        continue;
+                    }
+                    for (r++; r < ends[p] && records[r].kind !=
+                         window_record_kind::global_time; r++) {
+                        _step.push_back(&records[r]);
+                    }
+                }
+                std::sort(_step.begin(), _step.end(),
+                    [](const window_record<TIME> *a,
+                       const window_record<TIME> *b) {
+                        return a->kind != b->kind ? a->kind < b->kind :
+                            a->model < b->model;
+                    });
+                for (const window_record<TIME> *record : _step) {
+                    if (record->kind == window_record_kind::messages) {
+                        LOGGER::template log<cadmium::logger::logger_messages,
+                            cadmium::logger::sim_messages_collect>(t,
+                                _names[record->model], record->text);
+                    }
+                    else {
+                        LOGGER::template log<cadmium::logger::logger_state,
+                            cadmium::logger::sim_state>(t,
+                                _names[record->model], record->text);
+                    }
+                }
+            }
+            for (size_t p = 0; p < logs.size(); p++) {
+                std::vector<window_record<TIME>> &records = logs[p]->records;
+                records.erase(records.begin(), records.begin() + ends[p]);
+            }
+        }
+
+    private:
+        const std::vector<std::string> &_names;
+        std::vector<size_t> _next;   //!< Next record of every log.
+        std::vector<const window_record<TIME> *> _step;
+};
+
+/**
+ * The round_threads class runs a job for every partition in rounds,
+ * for partition 0 in the calling thread and for every other one in
+ * a thread of its own. A round returns when all jobs are done.
+*/
+class round_threads {
+    public:
+        using job = std::function<void(size_t partition, int command)>;
+
+        ~round_threads() {
+            stop();
+        }
+
+        /**
+         * Function that starts the threads of the partitions.
+        */
+        void start(size_t partitions, job work) {
+            _job = std::move(work);
+            for (size_t p = 1; p < partitions; p++) {
+                _workers.emplace_back(&round_threads::work, this, p);
+            }
+        }
+
+        /**
+         * Function that runs a round of the command.
+        */
+        void run(int command) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _command = command;
+                _round++;
+                _pending = _workers.size();
+            }
+            _work.notify_all();
+            if (command != STOP) {
+                _job(0, command);
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this] { return _pending == 0; });
+        }
+
+        /**
+         * Function that stops and joins the threads.
+        */
+        void stop() {
+            if (!_workers.empty()) {
+                run(STOP);
+                for (std::thread &worker : _workers) {
+                    worker.join();
+                }
+                _workers.clear();
+            }
+        }
+
+    private:
+        static constexpr int STOP = -1;
+
+        job _job;
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+        std::condition_variable _work;
+        std::condition_variable _done;
+        int _command = 0;
+        uint64_t _round = 0;
+        size_t _pending = 0;
+
+        void work(size_t p) {
+            uint64_t round = 0;
+            for (;;) {
+                int command;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _work.wait(lock, [&] { return _round != round; });
+                    round = _round;
+                    command = _command;
+                }
+                if (command != STOP) {
+                    _job(p, command);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (--_pending == 0) {
+                        _done.notify_one();
+                    }
+                }
+                if (command == STOP) {
+                    return;
+                }
+            }
+        }
+};
+
+/**
+ * Function that deals the connected components of the links between
+ * models to partitions, the largest component first to the partition
+ * with the fewest models.
+ * @param models number of models
+ * @param links pairs of linked models
+ * @param threads largest number of partitions
+ * @param owner partition of every model
+ * @return number of partitions
+*/
+inline size_t deal_components(size_t models,
+    const std::vector<std::pair<size_t, size_t>> &links, unsigned threads,
+    std::vector<size_t> &owner) {
+    std::vector<size_t> parent(models);
+    for (size_t m = 0; m < models; m++) {
+        parent[m] = m;
+    }
+    auto root = [&](size_t m) {
+        while (parent[m] != m) {
+            m = parent[m] = parent[parent[m]];
+        }
+        return m;
+    };
+    for (const std::pair<size_t, size_t> &link : links) {
+        size_t a = root(link.first);
+        size_t b = root(link.second);
+        parent[std::max(a, b)] = std::min(a, b);
+    }
+
+    std::vector<std::vector<size_t>> components;
+    std::vector<size_t> component(models);
+    for (size_t m = 0; m < models; m++) {
+        size_t r = root(m);
+        if (r == m) {
+            component[m] = components.size();
+            components.emplace_back();
+        }
+        component[m] = component[r];
+        components[component[m]].push_back(m);
+    }
+    std::stable_sort(components.begin(), components.end(),
+        [](const std::vector<size_t> &a, const std::vector<size_t> &b) {
+            return a.size() > b.size();
+        });
+
+    size_t count = std::max(std::min((size_t) threads, components.size()),
+                            (size_t) 1);
+    std::vector<size_t> load(count, 0);
+    owner.assign(models, 0);
+    for (const std::vector<size_t> &members : components) {
+        size_t p = std::min_element(load.begin(), load.end()) - load.begin();
+        for (size_t m : members) {
+            owner[m] = p;
+        }
+        load[p] += members.size();
+    }
+    return count;
+}
+
+/**
+ * The parallel_runner class simulates the independent parts of
+ * a flat coupled model in threads of their own.
+*/
+template<typename TIME, typename LOGGER>
+class parallel_runner {
+    using partition_runner = heap_runner<TIME, window_logger<TIME>>;
+
+    public:
+        /**
+         * Constructor of the runner.
+         * @param threads number of threads, 0 for one per core
+         * @param window width of the time windows
+        */
+        parallel_runner(unsigned threads, const TIME &window) :
+            _threads(threads ? threads : std::thread::hardware_concurrency()),
+            _window(window) {
+            if (_threads == 0) {
+                _threads = 1;
+            }
+        }
+
+        /**
+         * Function that adds an atomic model. It is built by the
+         * thread of its partition when the simulation starts.
+         * @param name model name
+         * @param args arguments of the constructor of the model
+        */
+        template<template<typename> class MODEL, typename... ARGS>
+        void add(const std::string &name, ARGS... args) {
+            assert(!_started && "models are added before the run");
+            _index.emplace(name, _names.size());
+            _names.push_back(name);
+            _factories.push_back([name, args...](partition_runner &runner) {
+                runner.template add<MODEL>(name, args...);
+            });
+        }
+
+        /**
+         * Function that couples an output port of a model to an
+         * input port of another one.
+        */
+        template<typename FROM_PORT, typename TO_PORT>
+        void couple(const std::string &from, const std::string &to) {
+            assert(!_started && "models are coupled before the run");
+            _couplings.push_back({from, to,
+                [from, to](partition_runner &runner) {
+                    runner.template couple<FROM_PORT, TO_PORT>(from, to);
+                }});
+        }
+
+        /**
+         * Function that connects an output port of a model to an
+         * output port of the TOP model, which goes nowhere.
+        */
+        template<typename FROM_PORT, typename TO_PORT>
+        void output(const std::string &) {
+        }
+
+        /** @return number of models */
+        size_t models() const { return _names.size(); }
+
+        /** @return number of partitions, known after the start */
+        size_t partitions() const { return _partitions.size(); }
+
+        /**
+         * Function that partitions the models, starts the threads
+         * and starts the simulation at the initial time.
+         * @param initial_time time of the start
+        */
+        void start(const TIME &initial_time) {
+            _started = true;
+            build_partitions();
+            _time = initial_time;
+            _pool.start(_partitions.size(),
+                [this](size_t p, int c) { execute(p, (command) c); });
+            _pool.run((int) command::start);
+            merge();
+        }
+
+        /**
+         * Function that simulates the events before time t.
+         * @param t time to simulate until
+         * @return time of the next event
+        */
+        TIME run_until(const TIME &t) {
+            if (!_started) {
+                start(TIME());
+            }
+            for (;;) {
+                TIME next = next_event();
+                if (!(next < t)) {
+                    return next;
+                }
+                _time = next + _window;
+                if (t < _time) {
+                    _time = t;
+                }
+                _pool.run((int) command::window);
+                merge();
+            }
+        }
+
+    private:
+        enum class command { start, window };
+
+        /**
+         * Structure that holds a coupling until the models are known.
+        */
+        struct coupling {
+            std::string from;
+            std::string to;
+            std::function<void(partition_runner &)> add;
+        };
+
+        /**
+         * Structure that holds a partition and its log.
+        */
+        struct partition {
+            partition_runner runner;
+            window_log<TIME> log;
+            std::vector<size_t> models;
+            std::vector<const coupling *> couplings;
+        };
+
+        unsigned _threads;
+        TIME _window;
+        bool _started = false;
+
+        std::vector<std::string> _names;
+        std::unordered_map<std::string, size_t> _index;
+        std::vector<std::function<void(partition_runner &)>> _factories;
+        std::vector<coupling> _couplings;
+        std::vector<std::unique_ptr<partition>> _partitions;
+        TIME _time;   //!< Initial time or end of the window.
+
+        window_merger<TIME, LOGGER> _merger{_names};
+        std::vector<window_log<TIME> *> _logs;
+        std::vector<size_t> _ends;
+        round_threads _pool;   //!< Declared last, stopped first.
+
+        size_t model_index(const std::string &name) const {
+            auto it = _index.find(name);
+            assert(it != _index.end() && "coupled model added");
+            return it->second;
+        }
+
+        /**
+         * Function that deals the components of the couplings
+         * to the partitions.
+        */
+        void build_partitions() {
+            std::vector<std::pair<size_t, size_t>> links;
+            for (const coupling &c : _couplings) {
+                links.emplace_back(model_index(c.from), model_index(c.to));
+            }
+            std::vector<size_t> owner;
+            size_t count = deal_components(_names.size(), links, _threads,
+                                           owner);
+            for (size_t p = 0; p < count; p++) {
+                _partitions.push_back(std::make_unique<partition>());
+                _partitions[p]->log.index = &_index;
+                _logs.push_back(&_partitions[p]->log);
+            }
+            for (size_t m = 0; m < _names.size(); m++) {
+                _partitions[owner[m]]->models.push_back(m);
+            }
+            for (const coupling &c : _couplings) {
+                size_t p = owner[model_index(c.from)];
+                _partitions[p]->couplings.push_back(&c);
+            }
+        }
+
+        void execute(size_t p, command what) {
+            partition &part = *_partitions[p];
+            window_logger<TIME>::current = &part.log;
+            if (what == command::start) {
+                for (size_t m : part.models) {
+                    _factories[m](part.runner);
+                }
+                for (const coupling *c : part.couplings) {
+                    c->add(part.runner);
+                }
+                part.runner.start(_time);
+            }
+            else {
+                part.runner.run_until(_time);
+            }
+        }
+
+        TIME next_event() const {
+            TIME next = std::numeric_limits<TIME>::infinity();
+            for (const std::unique_ptr<partition> &p : _partitions) {
+                TIME time = p->runner.next_event();
+                if (time < next) {
+                    next = time;
+                }
+            }
+            return next;
+        }
+
+        /**
+         * Function that logs the records of the window.
+        */
+        void merge() {
+            _ends.clear();
+            for (const window_log<TIME> *log : _logs) {
+                _ends.push_back(log->records.size());
+            }
+            _merger.merge(_logs, _ends);
+        }
+};
+
+#endif // __PARALLEL_RUNNER_HPP__
@@ -0,0 +1,117 @@
+/** \brief This header file declares the parameter sweep.
+ *
+ * A sweep design gives the values of some constants of the
+ * topology config for every design point. It is read from a
+ * string that starts with the kind of design:
+ *
+ * - "grid key=min:max:steps ...": every combination of steps
+ *   evenly spaced values of every key (steps 1 is min),
+ * - "lhs=N key=min:max ...": N points of a Latin hypercube, so
+ *   the range of every key is split into N strata and every
+ *   stratum is sampled once.
+ *
+ * The keys are the model constants of abp_topology_config, such
+ * as timeout or delivery. The runs of a sweep are scheduled on a
+ * work stealing thread pool.
+*/
+
+#ifndef __PARAMETER_SWEEP_HPP__
+#define __PARAMETER_SWEEP_HPP__
+
+#include <stdint.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "abp_topology.hpp"
+
+/**
+ * Structure that holds the range of a swept constant.
+*/
+struct sweep_parameter {
+    std::string key;       //!< Key of the constant in the topology config.
+    double min = 0;        //!< First value.
+    double max = 0;        //!< Last value.
+    unsigned steps = 1;    //!< Number of values of a grid.
+};
+
+/**
+ * The sweep_design class holds the design points of a sweep.
+*/
+class sweep_design {
+    public:
+        /**
+         * Function that reads the design.
+         * @param text design string
+         * @param seed seed of the Latin hypercube sample
+         * @param error description of the first wrong parameter
+         * @return true if the design is valid
+        */
+        bool parse(const char *text, uint64_t seed, std::string &error);
+
+        /** @return swept constants */
+        const std::vector<sweep_parameter> &parameters() const {
+            return _parameters;
+        }
+
+        /** @return number of design points */
+        size_t points() const { return _points.size(); }
+
+        /** @return values of the constants at a design point */
+        const std::vector<double> &point(size_t p) const {
+            return _points[p];
+        }
+
+        /**
+         * Function that sets the constants of a design point.
+         * @param p design point
+         * @param config topology config to change
+         * @param error description of a value the config refuses
+         * @return true if every value was set
+        */
+        bool apply(size_t p, abp_topology_config &config,
+                   std::string &error) const;
+
+    private:
+        std::vector<sweep_parameter> _parameters;
+        std::vector<std::vector<double>> _points;
+};
+
+/**
+ * The work_stealing_pool class runs tasks on worker threads.
+ * The tasks are dealt to the queues of the workers in turn.
+ * A worker runs the tasks of its own queue from the back and,
+ * when it is empty, steals from the front of the other queues,
+ * so the workers stay busy when the runs take unequal times.
+*/
+class work_stealing_pool {
+    public:
+        explicit work_stealing_pool(unsigned workers);
+
+        /** @return number of worker threads */
+        unsigned workers() const { return _queues.size(); }
+
+        /**
+         * Function that runs task(0) to task(n - 1) and returns
+         * when all have finished.
+        */
+        void run(size_t n, const std::function<void(size_t)> &task);
+
+    private:
+        struct queue_type {
+            std::mutex lock;
+            std::deque<size_t> tasks;
+        };
+
+        std::vector<queue_type> _queues;
+
+        /**
+         * Function that takes the next task of a worker.
+         * @return false if no queue has tasks left
+        */
+        bool next_task(unsigned worker, size_t &task);
+};
+
+#endif // __PARAMETER_SWEEP_HPP__
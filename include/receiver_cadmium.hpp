@@ -68,6 +68,14 @@ class Receiver {
             state.ack_num     = 0;
             state.sending     = false;
         }
+
+        /**
+         * Constructor for Receiver class with given delay constant.
+         * @param preparation_time delay from packet to acknowledge
+        */
+        Receiver(TIME preparation_time) noexcept : Receiver() {
+            PREPARATION_TIME  = preparation_time;
+        }
             
         /**
          * Structure that holds acknowledge number and receiver state.
@@ -109,7 +117,7 @@ class Receiver {
                 assert(false && "one message per time uniti");
             }
             for (const auto &x : get_messages<typename defs::in>(mbs)) {
-                state.ack_num = static_cast<int>(x.value);
+                state.ack_num = x.bit;
                 state.sending = true;
             }  
         }
@@ -128,15 +136,13 @@ class Receiver {
 
         /**
          * Function that sends the acknowledge to the output port.
-         * The acknowledge is calculated as remainder of message value
-         * divided by 10. 
+         * The acknowledge is the alternating bit of the packet.
          * @return Message bags
         */
         typename make_message_bags<output_ports>::type output() const {
             typename make_message_bags<output_ports>::type bags;
-            Message_t out;
-            out.value = state.ack_num % 10;  
-            get_messages<typename defs::out>(bags).push_back(out);
+            get_messages<typename defs::out>(bags).push_back(
+                Message_t::ack(state.ack_num));
             return bags;
         }
 
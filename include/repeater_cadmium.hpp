@@ -68,7 +68,16 @@ public:
     Repeater() noexcept {
         PREPARATION_TIME = TIME("00:00:10");
         state.ack    = 0;
-        state.packet = 0;
+        state.sending = false;
+        state.packet.clear();
+    }
+
+    /**
+     * Constructor for Repeater class with given delay constant.
+     * @param preparation_time delay from input to output
+    */
+    Repeater(TIME preparation_time) noexcept : Repeater() {
+        PREPARATION_TIME = preparation_time;
     }
 
     /**
@@ -79,8 +88,8 @@ public:
     struct state_type {
         bool ack;
         bool sending;
-        int packet;
-        int ack_packet;
+        Message_t packet;
+        Message_t ack_packet;
     };
     state_type state;
 
@@ -118,14 +127,14 @@ public:
             assert(false && "One message at a time");
         }
         for (const auto &x : get_messages<typename defs::packet_in>(mbs)) {
-            state.packet = static_cast<int>(x.value);
+            state.packet = x;
             state.sending = true;
         }
         if (get_messages<typename defs::ack_in>(mbs).size() > 1) {
             assert(false && "One message at a time");
         }
         for (const auto &x : get_messages<typename defs::ack_in>(mbs)) {
-            state.ack_packet = static_cast<int>(x.value);
+            state.ack_packet = x;
             state.ack = true;
         }
     }
@@ -153,15 +162,12 @@ public:
     */
     typename make_message_bags<output_ports>::type output() const {
         typename make_message_bags<output_ports>::type bags;
-        Message_t out;
         if (state.sending) {
-            out.value = state.packet;
-            get_messages<typename defs::packet_sent_out>(bags).push_back(out);
+            get_messages<typename defs::packet_sent_out>(bags).push_back(state.packet);
         }
         if (state.ack)
         {
-            out.value = state.ack_packet;
-            get_messages<typename defs::ack_received_out>(bags).push_back(out);
+            get_messages<typename defs::ack_received_out>(bags).push_back(state.ack_packet);
         }
         return bags;
     }
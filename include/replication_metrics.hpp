@@ -0,0 +1,203 @@
+/** \brief This header file declares the metrics of a replication.
+ *
+ * A replication is one run of the simulator with its own seed.
+ * Instead of writing the log, the metrics logger reads the output
+ * messages of the Senders as they are logged and keeps the counters
+ * of the replication in memory. The messages logged by the runners
+ * of this repo are read from their fields; only bags logged as text,
+ * as by the Cadmium runner, are formatted and read back:
+ *
+ * - transmissions: packets sent, including retransmissions,
+ * - retransmissions: packets sent again after a timeout,
+ * - delivered: packets acknowledged,
+ * - ack latency: time from the first transmission of a packet
+ *   to its acknowledgement.
+ *
+ * The counters are thread_local, so every worker thread of the
+ * replication runner collects the metrics of its own replication.
+ * The statistics over the replications are reported with their
+ * confidence intervals.
+*/
+
+#ifndef __REPLICATION_METRICS_HPP__
+#define __REPLICATION_METRICS_HPP__
+
+#include <cadmium/logger/common_loggers.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "filter_logger.hpp"
+#include "message.hpp"
+#include "time_ticks.hpp"
+
+/**
+ * Structure that holds the metrics of one replication.
+*/
+struct replication_metrics {
+    double seconds = 0;             //!< Simulated time.
+    uint64_t transmissions = 0;     //!< Packets sent, with retransmissions.
+    uint64_t retransmissions = 0;   //!< Packets sent again.
+    uint64_t delivered = 0;         //!< Packets acknowledged.
+    double latency_sum = 0;         //!< Sum of the ack latencies in seconds.
+
+    /** @return packets sent per second */
+    double throughput() const {
+        return seconds > 0 ? transmissions / seconds : 0;
+    }
+    /** @return packets acknowledged per second */
+    double goodput() const {
+        return seconds > 0 ? delivered / seconds : 0;
+    }
+    /** @return mean ack latency in seconds */
+    double ack_latency() const {
+        return delivered > 0 ? latency_sum / delivered : 0;
+    }
+    /** @return fraction of the transmissions that were retransmissions */
+    double retransmission_rate() const {
+        return transmissions > 0 ? (double) retransmissions / transmissions : 0;
+    }
+};
+
+/**
+ * The metrics_collector class keeps the metrics of the replication
+ * run by the current thread.
+*/
+class metrics_collector {
+    public:
+        /**
+         * Function that returns the collector of the current thread.
+        */
+        static metrics_collector &current();
+
+        /**
+         * Function that clears the metrics for a new replication.
+        */
+        void reset();
+
+        /**
+         * Function that sets the time of the messages that follow.
+         * @param ticks time in milliseconds
+        */
+        void time(int64_t ticks);
+
+        /**
+         * Function that reads the messages of a model from their
+         * fields.
+         * @param model model name
+         * @param bag messages of the model and names of its ports
+        */
+        void messages(std::string_view model, const message_bag_text &bag);
+
+        /**
+         * Function that reads a formatted message line, as
+         * "[port: {v}, ...] generated by model X".
+        */
+        void message_line(std::string_view line);
+
+        /**
+         * Function that returns the metrics up to the given time.
+         * @param seconds simulated time in seconds
+        */
+        replication_metrics finish(double seconds) const;
+
+    private:
+        struct sender_type {
+            /**
+             * first transmission of every packet not acknowledged,
+             * by session and packet number
+            */
+            std::unordered_map<uint64_t, int64_t> outstanding;
+        };
+
+        /** indexes of the Sender output ports, -1 if missing */
+        struct sender_ports {
+            int sent;
+            int acked;
+        };
+
+        void sent(sender_type &sender, uint64_t packet);
+        void acknowledged(sender_type &sender, uint64_t packet,
+                          bool alternating_bit);
+        const sender_ports &ports_of(const std::vector<std::string> &names);
+
+        int64_t _ticks = 0;
+        replication_metrics _metrics;
+        std::unordered_map<std::string, sender_type> _senders;
+        std::unordered_map<const std::vector<std::string>*,
+                           sender_ports> _ports;
+};
+
+/**
+ * The metrics_logger class is a logger that passes the logged
+ * time and messages to the metrics_collector of the thread.
+ * It has the same parameters as cadmium::logger::logger, so it
+ * can be used in its place. The time and the messages of a
+ * message_bag_text are passed as they are, other bags are
+ * formatted first unless they are empty.
+*/
+template<typename LOGGING_SOURCE, typename FORMATTER, typename SINK_PROVIDER>
+struct metrics_logger {
+    template<typename DECLARED_SOURCE, typename INFO, typename... PARAMs>
+    static void log(const PARAMs&... ps) {
+        if constexpr (std::is_same<LOGGING_SOURCE, DECLARED_SOURCE>::value) {
+            if constexpr (std::is_same<LOGGING_SOURCE,
+                cadmium::logger::logger_global_time>::value) {
+                log_time(ps...);
+            }
+            else if constexpr (std::is_same<LOGGING_SOURCE,
+                cadmium::logger::logger_messages>::value) {
+                log_messages<INFO>(ps...);
+            }
+        }
+    }
+
+    private:
+        template<typename TIME>
+        static void log_time(const TIME &t) {
+            metrics_collector::current().time(time_to_ticks(t));
+        }
+
+        template<typename INFO, typename TIME>
+        static void log_messages(const TIME &t, const std::string &model,
+                                 const message_bag_text &bag) {
+            if (bag.messages != nullptr && bag.ports != nullptr) {
+                metrics_collector::current().messages(model, bag);
+            }
+            else if (!is_empty_bag_text(bag)) {
+                metrics_collector::current().message_line(
+                    FORMATTER::template format<INFO>(t, model, bag)());
+            }
+        }
+
+        template<typename INFO, typename... PARAMs>
+        static void log_messages(const PARAMs&... ps) {
+            if ((is_empty_bag_param(ps) || ...)) {
+                return;
+            }
+            metrics_collector::current().message_line(
+                FORMATTER::template format<INFO>(ps...)());
+        }
+};
+
+/**
+ * Structure that holds the statistics of a metric over replications.
+*/
+struct metric_summary {
+    double mean = 0;
+    double stddev = 0;
+    double half_width = 0;   //!< Half width of the 95% confidence interval.
+};
+
+/**
+ * Function that computes the statistics of a metric.
+ * @param values metric of every replication
+ * @return mean, standard deviation and 95% confidence interval
+*/
+metric_summary summarize(const std::vector<double> &values);
+
+#endif // __REPLICATION_METRICS_HPP__
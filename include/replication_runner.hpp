@@ -0,0 +1,40 @@
+/** \brief This header file declares the simulation of one replication.
+ *
+ * A replication builds its TOP model with abp_topology and simulates
+ * it with the metrics logger, so no log is written. Replication r
+ * uses the seed of the topology plus r for the Subnets and, with a
+ * traffic spec, for the generators. It is used by the replication
+ * runner and by the parameter sweep.
+*/
+
+#ifndef __REPLICATION_RUNNER_HPP__
+#define __REPLICATION_RUNNER_HPP__
+
+#include "abp_topology.hpp"
+#include "traffic_generator_cadmium.hpp"
+#include "replication_metrics.hpp"
+
+#define REPLICATION_RUN_UNTIL "04:00:00:000"
+#define REPLICATION_RUN_SECONDS (4 * 3600)
+
+/**
+ * Structure that holds the workload of the replications: an input
+ * file replayed to every channel or a traffic spec.
+*/
+struct replication_input {
+    bool traffic = false;              //!< True to use the traffic spec.
+    const char *input_file = nullptr;  //!< Input file of the generator.
+    traffic_spec spec;                 //!< Traffic spec of the generators.
+};
+
+/**
+ * Function that simulates one replication.
+ * @param r replication number
+ * @param input workload of the replication
+ * @param config topology and model constants
+ * @return metrics of the replication
+*/
+replication_metrics run_replication(unsigned r, const replication_input &input,
+                                    abp_topology_config config);
+
+#endif // __REPLICATION_RUNNER_HPP__
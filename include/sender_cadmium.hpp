@@ -15,6 +15,19 @@
  * window, the sender will send the next packet. When
  * there are no more packets to send, the sender will
  * go again to the passive state. 
+ *
+ * Control messages received while the sender is active are ignored,
+ * unless the sender queues arrivals: then they add their packets
+ * after the packets still to be sent, as the arrivals of a traffic
+ * generator. Every packet is output with the session of the control
+ * message it belongs to.
+ *
+ * With the adaptive timeout the wait time is the retransmission
+ * timeout of Jacobson and Karels: the round trip time from the
+ * output of a packet to its acknowledgement is smoothed into SRTT
+ * and RTTVAR, and the timeout is SRTT + 4 RTTVAR, between
+ * MIN_TIMEOUT and TIMEOUT. Packets sent again give no sample and
+ * every timeout doubles the wait time, up to TIMEOUT.
 */
 /* 
 * Cristina Ruiz Martin
@@ -36,10 +49,12 @@
 #include <string>
 #include <chrono>
 #include <algorithm>
+#include <deque>
 #include <limits>
 #include <random>
 
 #include "message.hpp"
+#include "time_ticks.hpp"
 
 using namespace cadmium;
 using namespace std;
@@ -74,6 +89,9 @@ class Sender {
         TIME TIMEOUT;             /**< Constant that holds the timeout delay */
                                   /**< from output to acknowledge. */
                                   //!<Timeout constant.
+        TIME MIN_TIMEOUT;         //!< Smallest adaptive timeout.
+        bool ADAPTIVE_TIMEOUT;    //!< True - timeout from the RTT estimate.
+        bool QUEUE_ARRIVALS;      //!< True - controls queued while active.
         
         /** 
          * Constructor for Sender class.
@@ -82,10 +100,58 @@ class Sender {
         Sender() noexcept {
             PREPARATION_TIME = TIME("00:00:10");
             TIMEOUT          = TIME("00:01:00");
+            MIN_TIMEOUT      = TIME("00:00:01");
+            ADAPTIVE_TIMEOUT = false;
+            QUEUE_ARRIVALS   = false;
+            state.ack        = false;
+            state.packet_num = 0;
+            state.total_packet_num = 0;
             state.alt_bit    = 0;
+            state.sending    = false;
+            state.retransmitted    = false;
+            state.rto              = TIMEOUT;
+            state.srtt             = -1;
+            state.rttvar           = 0;
             state.next_internal    = std::numeric_limits<TIME>::infinity();
             state.model_active     = false;
         }
+
+        /**
+         * Constructor for Sender class with given delay constants.
+         * @param preparation_time delay from acknowledge to output
+         * @param timeout delay from output to retransmission
+        */
+        Sender(TIME preparation_time, TIME timeout) noexcept : Sender() {
+            PREPARATION_TIME = preparation_time;
+            TIMEOUT          = timeout;
+            state.rto        = timeout;
+        }
+
+        /**
+         * Constructor for Sender class with the adaptive timeout.
+         * @param preparation_time delay from acknowledge to output
+         * @param timeout first and largest retransmission timeout
+         * @param adaptive_timeout true to estimate the timeout
+        */
+        Sender(TIME preparation_time, TIME timeout,
+               bool adaptive_timeout) noexcept :
+            Sender(preparation_time, timeout) {
+            ADAPTIVE_TIMEOUT = adaptive_timeout;
+        }
+
+        /**
+         * Constructor for Sender class that may queue the control
+         * messages received while it is active.
+         * @param preparation_time delay from acknowledge to output
+         * @param timeout first and largest retransmission timeout
+         * @param adaptive_timeout true to estimate the timeout
+         * @param queue_arrivals true to queue the control messages
+        */
+        Sender(TIME preparation_time, TIME timeout,
+               bool adaptive_timeout, bool queue_arrivals) noexcept :
+            Sender(preparation_time, timeout, adaptive_timeout) {
+            QUEUE_ARRIVALS = queue_arrivals;
+        }
             
         /**
          * Structure that holds the state variables.
@@ -98,6 +164,13 @@ class Sender {
             bool sending;          //!< State: true - sending.
             bool model_active;     //!< True - model is active.
             TIME next_internal;    //!< Time of next internal transition.
+            bool retransmitted;    //!< True - packet was sent again.
+            TIME rto;              //!< Retransmission timeout.
+            double srtt;           //!< Smoothed RTT in ms, -1 if none.
+            double rttvar;         //!< RTT variation in ms.
+            std::deque<std::pair<int, uint16_t>> arrivals;
+                                   //!< Last packet and session of every
+                                   //!< control message not sent yet.
         }; 
         state_type state;
             
@@ -115,14 +188,19 @@ class Sender {
             if (state.ack) {
                 if (state.packet_num < state.total_packet_num) {
                     state.packet_num++;
+                    while (state.arrivals.front().first < state.packet_num) {
+                        state.arrivals.pop_front();
+                    }
                     state.ack = false;
                     state.alt_bit = (state.alt_bit + 1) % 2;
                     state.sending = true;
+                    state.retransmitted = false;
                     state.model_active = true; 
                     state.next_internal = PREPARATION_TIME;   
                 } 
                 else {
                     state.model_active = false;
+                    state.arrivals.clear();
                     state.next_internal = 
                     std::numeric_limits<TIME>::infinity();
                 }
@@ -131,9 +209,14 @@ class Sender {
                 if (state.sending) {
                     state.sending = false;
                     state.model_active = true;
-                    state.next_internal = TIMEOUT;
+                    state.next_internal = state.rto;
                 }
                 else {
+                    if (ADAPTIVE_TIMEOUT) {
+                        state.rto = state.rto + state.rto < TIMEOUT ?
+                            state.rto + state.rto : TIMEOUT;
+                    }
+                    state.retransmitted = true;
                     state.sending = true;
                     state.model_active = true;
                     state.next_internal = PREPARATION_TIME;    
@@ -143,50 +226,64 @@ class Sender {
 
         /**
          * Function that performs external transition.
-         * Retrieves the messages: if the number of messages
-         * is more than 1, it asserts that only one message is
-         * expected per time unit. After that it determines
-         * and sets the next state based on the current state.
-         * It also sets the time of next internal transition.
+         * Unless the model queues arrivals, it asserts that only
+         * one message is expected per time unit, and a control
+         * message received while active is ignored. The time of
+         * next internal transition is reduced by the elapsed time
+         * on every message, ignored ones included.
+         * A control message starts a passive model; queued, it
+         * adds its packets to be sent. An acknowledge with the
+         * alternating bit of the packet sent makes the model
+         * output it.
          * @param e time variable
          * @param mbs message bags
         */
         void external_transition(TIME e,
             typename make_message_bags<input_ports>::type mbs) { 
-            if ((get_messages<typename defs::control_in>(mbs).size()
+            if (!QUEUE_ARRIVALS &&
+                (get_messages<typename defs::control_in>(mbs).size()
                 +get_messages<typename defs::ack_in>(mbs).size()) > 1) {
                 assert(false && "one message per time uniti");
             }
+            if (state.next_internal !=
+                std::numeric_limits<TIME>::infinity()) {
+                state.next_internal = state.next_internal - e;
+            }
             for (const auto &x :
                 get_messages<typename defs::control_in>(mbs)) {
                 if (state.model_active == false) {
-                    state.total_packet_num = static_cast<int>(x.value);
-                    if (state.total_packet_num > 0) {
+                    state.total_packet_num = 0;
+                    if (x.seq > 0) {
                         state.packet_num = 1;
                         state.ack = false;
                         state.sending = true;
+                        state.retransmitted = false;
                         /** set initial alt_bit */
                         state.alt_bit = state.packet_num % 2;
                         state.model_active = true;
                         state.next_internal = PREPARATION_TIME;
                     }
-                    else if (state.next_internal != 
-                        std::numeric_limits<TIME>::infinity()) {
-                        state.next_internal = state.next_internal - e;
-                    }
+                }
+                else if (!QUEUE_ARRIVALS) {
+                    continue;
+                }
+                if (x.seq > 0) {
+                    state.total_packet_num += x.seq;
+                    state.arrivals.emplace_back(state.total_packet_num,
+                                                x.session);
                 }
             }
             for (const auto &x : get_messages<typename defs::ack_in>(mbs)) {
-                if (state.model_active == true) { 
-                    if (state.alt_bit == static_cast<int>(x.value)) {
-                        state.ack = true;
-                        state.sending = false;
-                        state.next_internal = TIME("00:00:00");
-                    }
-                    else if(state.next_internal !=
-                        std::numeric_limits<TIME>::infinity()) {
-                        state.next_internal = state.next_internal - e;
+                if (state.model_active == true &&
+                    state.alt_bit == x.bit) {
+                    if (ADAPTIVE_TIMEOUT && !state.sending &&
+                        !state.retransmitted) {
+                        /** time since the output of the packet */
+                        sample_rtt(state.rto - state.next_internal);
                     }
+                    state.ack = true;
+                    state.sending = false;
+                    state.next_internal = TIME("00:00:00");
                 }
             }                     
         }
@@ -211,23 +308,23 @@ class Sender {
          * to message bags.
          * When in acknowledge state, the alt_bit is
          * assigned to output and the output is pushed
-         * to message bags.
+         * to message bags. Both carry the session of the packet.
          * @return Message bags
         */
         typename make_message_bags<output_ports>::type output() const {
             typename make_message_bags<output_ports>::type bags;
-            Message_t out;
+            uint16_t session = state.arrivals.empty() ? 0 :
+                state.arrivals.front().second;
             if (state.sending) {
-                out.value = state.packet_num * 10 + state.alt_bit;
-                get_messages<typename defs::data_out>(bags).push_back(out);
-                out.value = state.packet_num;
-                get_messages<typename
-                    defs::packet_sent_out>(bags).push_back(out);
+                get_messages<typename defs::data_out>(bags).push_back(
+                    Message_t::data(state.packet_num, state.alt_bit,
+                                    session));
+                get_messages<typename defs::packet_sent_out>(bags).push_back(
+                    Message_t::number(state.packet_num, session));
             }
             else if (state.ack) {
-                out.value = state.alt_bit;
-                get_messages<typename
-                    defs::ack_received_out>(bags).push_back(out);
+                get_messages<typename defs::ack_received_out>(bags).push_back(
+                    Message_t::ack(state.alt_bit, session));
             }   
             return bags;
         }
@@ -252,8 +349,35 @@ class Sender {
             const typename Sender<TIME>::state_type& i) {
             os << "packetNum: " << i.packet_num << 
                 " & totalPacketNum: " << i.total_packet_num; 
+            if (i.srtt >= 0) {
+                os << " & srtt: " << i.srtt / 1000 << " & rttvar: " <<
+                    i.rttvar / 1000 << " & rto: " << i.rto;
+            }
             return os;
         }
+
+    private:
+        /**
+         * Function that updates the RTT estimate and the
+         * retransmission timeout with a round trip time.
+         * @param rtt round trip time of a packet sent once
+        */
+        void sample_rtt(TIME rtt) {
+            double r = (double) time_to_ticks(rtt);
+            if (state.srtt < 0) {
+                state.srtt = r;
+                state.rttvar = r / 2;
+            }
+            else {
+                state.rttvar = 0.75 * state.rttvar +
+                    0.25 * fabs(state.srtt - r);
+                state.srtt = 0.875 * state.srtt + 0.125 * r;
+            }
+            TIME rto = ticks_to_time<TIME>(
+                llround(state.srtt + 4 * state.rttvar));
+            state.rto = rto < MIN_TIMEOUT ? MIN_TIMEOUT :
+                TIMEOUT < rto ? TIMEOUT : rto;
+        }
 };     
 
 #endif /** _SENDER_CADMIUM_HPP_ */
@@ -33,6 +33,7 @@
 #include <random>
 
 #include "message.hpp"
+#include "counter_rng.hpp"
 
 using namespace cadmium;
 using namespace std;
@@ -61,15 +62,42 @@ class Subnet {
 	 * Any Parameters to be overwritten
          * when instantiating the atomic model.
         */
+        double DELIVERY_PROBABILITY;   //!< Probability of delivering a packet.
+        double DELAY_MEAN;             //!< Mean delay in seconds.
+        double DELAY_STDDEV;           //!< Standard deviation of the delay.
 
         /**
          * Constructor for Subnet class.
          * Initializes the state structure
-         * to control the transmitting
+         * to control the transmitting. Every Subnet built this
+         * way draws the stream named subnet with run seed 0; a
+         * Subnet that needs a stream of its own is built with its
+         * name.
         */
-        Subnet() noexcept {
+        Subnet() noexcept : Subnet("subnet", 0) {
+        }
+
+        /**
+         * Constructor for Subnet class that selects the random
+         * number stream of the subnet from the run seed and its name,
+         * so every subnet draws its own reproducible delays and losses.
+         * @param name model name
+         * @param seed run seed
+         * @param delivery_probability probability of delivering a packet
+         * @param delay_mean mean delay in seconds
+         * @param delay_stddev standard deviation of the delay
+        */
+        Subnet(const std::string &name, uint64_t seed,
+               double delivery_probability = 0.95, double delay_mean = 3.0,
+               double delay_stddev = 1.0) noexcept {
+            DELIVERY_PROBABILITY  = delivery_probability;
+            DELAY_MEAN            = delay_mean;
+            DELAY_STDDEV          = delay_stddev;
             state.transmiting     = false;
             state.index           = 0;
+            state.delay           = 0;
+            state.lost            = false;
+            state.rng = counter_rng(seed, name);
         }
                 
         /**
@@ -81,8 +109,11 @@ class Subnet {
         */
         struct state_type {
             bool transmiting;
-            int packet;
+            Message_t packet;
             int index;
+            int delay;          //!< Delay of the packet in seconds.
+            bool lost;          //!< True if the packet is lost.
+            counter_rng rng;    //!< Random number stream of the subnet.
         }; 
         state_type state;
 		
@@ -106,7 +137,9 @@ class Subnet {
          * and if it is more that 1 it asserts giving the message
          * that only one message is expected per unit time.
          * Else it sets the message value to the packet that is
-         * going to be send and set the state to transmitting
+         * going to be send and set the state to transmitting.
+         * The delay and the loss of the packet are drawn here,
+         * so output and time advance only read them
          * @param e time variable
          * @param mbs message bags
         */
@@ -117,8 +150,11 @@ class Subnet {
 	        assert(false && "One message at a time");     
             }				
             for (const auto &x : get_messages<typename defs::in>(mbs)) {
-                state.packet = static_cast<int>(x.value);
+                state.packet = x;
                 state.transmiting = true; 
+                state.delay = max(0, static_cast<int>
+                    (round(state.rng.normal(DELAY_MEAN, DELAY_STDDEV))));
+                state.lost = state.rng.uniform() >= DELIVERY_PROBABILITY;
             }               
         }
 
@@ -142,10 +178,8 @@ class Subnet {
         */
         typename make_message_bags<output_ports>::type output() const {
             typename make_message_bags<output_ports>::type bags;
-            Message_t out;
-            if ((double)rand() / (double) RAND_MAX  < 0.95) {
-                out.value = state.packet;
-                get_messages<typename defs::out>(bags).push_back(out);
+            if (!state.lost) {
+                get_messages<typename defs::out>(bags).push_back(state.packet);
             }
             return bags;
         }
@@ -153,19 +187,16 @@ class Subnet {
         /**
          * Function sets next internal transmission time.
          * If the current state is transmitting then the next
-         * internal time is set to value generated by distribution function
-	 * that provides mean of 3.0 and standard deviation of 1.0
-         * otherwise it is set to infinity
+         * internal time is set to the delay drawn when the packet
+	 * arrived, from the normal distribution with mean of 3.0 and
+         * standard deviation of 1.0, otherwise it is set to infinity
          * @return next internal time
         */
         TIME time_advance() const {
-            std::default_random_engine generator;
-            std::normal_distribution<double> distribution(3.0, 1.0); 
             TIME next_internal;
             if (state.transmiting) {
                 std::initializer_list<int>
-	            time = {0, 0, static_cast<int>
-		        (round(distribution(generator)))};
+	            time = {0, 0, state.delay};
                 // time is hour min and second
                 next_internal = TIME(time);
             }
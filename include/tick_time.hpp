@@ -0,0 +1,198 @@
+/** \brief This header file implements the TickTime class.
+ *
+ * TickTime is a time type for the simulator with the interface of
+ * NDTime that the models and the runner use: construction from
+ * {hours, minutes, seconds, milliseconds, microseconds, nanoseconds}
+ * and from "HH:MM:SS:mmm" text, addition, subtraction, comparisons,
+ * the stream operators and std::numeric_limits<TickTime>::infinity().
+ * It holds a single int64_t count of nanoseconds, so these are
+ * integer operations; infinity is the largest count and stays
+ * infinity when a finite time is added or subtracted. Times are
+ * written as NDTime writes them, so logs do not change.
+*/
+
+#ifndef __TICK_TIME_HPP__
+#define __TICK_TIME_HPP__
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "time_ticks.hpp"
+
+/**
+ * The TickTime class is a time in integer nanoseconds.
+*/
+class TickTime {
+    public:
+        static constexpr int64_t NS_PER_MS = 1000000;   //!< Ticks of a ms.
+
+        constexpr TickTime() : _ticks(0) {
+        }
+
+        /**
+         * Constructor from {hours, minutes, seconds, milliseconds,
+         * microseconds, nanoseconds}; missing fields are zero.
+        */
+        TickTime(std::initializer_list<int> fields) : _ticks(0) {
+            static const int64_t scale[6] = {3600000000000LL, 60000000000LL,
+                1000000000LL, 1000000LL, 1000LL, 1LL};
+            int i = 0;
+            for (int field : fields) {
+                if (i < 6) {
+                    _ticks += field * scale[i++];
+                }
+            }
+        }
+
+        /**
+         * Constructor from "HH:MM:SS", "HH:MM:SS:mmm" and so on,
+         * up to nanoseconds, or "inf".
+        */
+        TickTime(const std::string &text) : TickTime(text.c_str()) {
+        }
+
+        TickTime(const char *text) : _ticks(0) {
+            if (text[0] == 'i') {
+                _ticks = INFINITE;
+                return;
+            }
+            int fields[6] = {0, 0, 0, 0, 0, 0};
+            sscanf(text, "%d:%d:%d:%d:%d:%d", &fields[0], &fields[1],
+                   &fields[2], &fields[3], &fields[4], &fields[5]);
+            *this = TickTime({fields[0], fields[1], fields[2], fields[3],
+                              fields[4], fields[5]});
+        }
+
+        /** @return time of a count of nanoseconds */
+        static constexpr TickTime from_ticks(int64_t ticks) {
+            return TickTime(ticks, 0);
+        }
+
+        /** @return count of nanoseconds */
+        constexpr int64_t ticks() const { return _ticks; }
+
+        constexpr bool is_infinity() const { return _ticks == INFINITE; }
+
+        TickTime operator+(const TickTime &o) const {
+            return is_infinity() || o.is_infinity() ? TickTime(INFINITE, 0) :
+                TickTime(_ticks + o._ticks, 0);
+        }
+        /**
+         * Infinity minus any time is infinity, a finite time minus
+         * infinity has no value.
+        */
+        TickTime operator-(const TickTime &o) const {
+            if (is_infinity()) {
+                return *this;
+            }
+            assert(!o.is_infinity() && "finite time minus infinity");
+            return TickTime(_ticks - o._ticks, 0);
+        }
+        TickTime &operator+=(const TickTime &o) { return *this = *this + o; }
+        TickTime &operator-=(const TickTime &o) { return *this = *this - o; }
+
+        constexpr bool operator<(const TickTime &o) const {
+            return _ticks < o._ticks;
+        }
+        constexpr bool operator>(const TickTime &o) const {
+            return _ticks > o._ticks;
+        }
+        constexpr bool operator<=(const TickTime &o) const {
+            return _ticks <= o._ticks;
+        }
+        constexpr bool operator>=(const TickTime &o) const {
+            return _ticks >= o._ticks;
+        }
+        constexpr bool operator==(const TickTime &o) const {
+            return _ticks == o._ticks;
+        }
+        constexpr bool operator!=(const TickTime &o) const {
+            return _ticks != o._ticks;
+        }
+
+    private:
+        static constexpr int64_t INFINITE = std::numeric_limits<int64_t>::max();
+
+        int64_t _ticks;   //!< Nanoseconds.
+
+        constexpr TickTime(int64_t ticks, int) : _ticks(ticks) {
+        }
+};
+
+namespace std {
+    /**
+     * Limits of TickTime; the runner asks for infinity.
+    */
+    template<>
+    class numeric_limits<TickTime> {
+        public:
+            static constexpr bool is_specialized = true;
+            static constexpr bool has_infinity = true;
+            static constexpr TickTime infinity() {
+                return TickTime::from_ticks(numeric_limits<int64_t>::max());
+            }
+            static constexpr TickTime max() {
+                return TickTime::from_ticks(numeric_limits<int64_t>::max() - 1);
+            }
+            static constexpr TickTime min() {
+                return TickTime();
+            }
+            static constexpr TickTime lowest() {
+                return TickTime::from_ticks(numeric_limits<int64_t>::min());
+            }
+    };
+}
+
+/**
+ * Function that writes a time as "HH:MM:SS:mmm", with the micro
+ * and nanoseconds after it when they are not zero.
+*/
+inline std::ostream &operator<<(std::ostream &os, const TickTime &t) {
+    if (t.is_infinity()) {
+        return os << "inf";
+    }
+    int64_t ticks = t.ticks();
+    char text[64];
+    const char *sign = "";
+    if (ticks < 0) {
+        sign = "-";
+        ticks = -ticks;
+    }
+    int64_t ms = ticks / TickTime::NS_PER_MS;
+    int64_t ns = ticks % TickTime::NS_PER_MS;
+    int n = snprintf(text, sizeof(text), "%s%02lld:%02lld:%02lld:%03lld", sign,
+                     (long long) (ms / 3600000), (long long) (ms / 60000 % 60),
+                     (long long) (ms / 1000 % 60), (long long) (ms % 1000));
+    if (ns != 0) {
+        snprintf(text + n, sizeof(text) - n, ":%03lld:%03lld",
+                 (long long) (ns / 1000), (long long) (ns % 1000));
+    }
+    return os << text;
+}
+
+/**
+ * Function that reads a time written as the constructor accepts it.
+*/
+inline std::istream &operator>>(std::istream &is, TickTime &t) {
+    std::string text;
+    if (is >> text) {
+        t = TickTime(text);
+    }
+    return is;
+}
+
+/**
+ * Function that converts a finite TickTime to milliseconds
+ * without writing it as text.
+*/
+template<>
+inline int64_t time_to_ticks<TickTime>(const TickTime &time) {
+    return time.ticks() / TickTime::NS_PER_MS;
+}
+
+#endif // __TICK_TIME_HPP__
@@ -0,0 +1,66 @@
+/** \brief This header file implements the conversion of milliseconds to TIME.
+ *
+ * Models and builders that compute times as integer milliseconds
+ * convert them to the TIME of the simulation with ticks_to_time.
+ * TIME must be constructible from {hours, minutes, seconds,
+ * milliseconds}, as NDTime is. time_to_ticks converts back from the
+ * "HH:MM:SS:mmm" text that TIME is logged with; NDTime and TickTime
+ * are converted from their fields without writing them as text.
+*/
+
+#ifndef __TIME_TICKS_HPP__
+#define __TIME_TICKS_HPP__
+
+#include <stdint.h>
+#include <sstream>
+#include <string>
+
+#include "../lib/DESTimes/include/NDTime.hpp"
+
+/**
+ * Function that converts milliseconds to TIME.
+ * @param ticks time in milliseconds
+ * @return time
+*/
+template<typename TIME>
+TIME ticks_to_time(int64_t ticks) {
+    return TIME({(int) (ticks / 3600000), (int) (ticks / 60000 % 60),
+                 (int) (ticks / 1000 % 60), (int) (ticks % 1000)});
+}
+
+/**
+ * Function that converts a finite TIME to milliseconds.
+ * @param time time
+ * @return time in milliseconds
+*/
+template<typename TIME>
+int64_t time_to_ticks(const TIME &time) {
+    std::ostringstream os;
+    os << time;
+    int64_t fields[4] = {0, 0, 0, 0};
+    int field = 0;
+    for (char c : os.str()) {
+        if (c == ':') {
+            if (++field == 4) {
+                break;
+            }
+        }
+        else if (c >= '0' && c <= '9') {
+            fields[field] = fields[field] * 10 + (c - '0');
+        }
+    }
+    return ((fields[0] * 60 + fields[1]) * 60 + fields[2]) * 1000
+           + fields[3];
+}
+
+/**
+ * Function that converts a finite NDTime to milliseconds
+ * without writing it as text.
+*/
+template<>
+inline int64_t time_to_ticks<NDTime>(const NDTime &time) {
+    return (((int64_t) time.getHours() * 60 + time.getMinutes()) * 60
+            + time.getSeconds()) * 1000 + time.getMilliseconds();
+}
+
+#endif // __TIME_TICKS_HPP__
@@ -0,0 +1,28 @@
+/** \brief This header file declares the compiler of timed event files.
+ *
+ * The input files of the generators list one event per line as
+ * "HH:MM:SS[:mmm] value". Reading them with the >> operators of
+ * the time and the message dominates the run time of generators
+ * with millions of events. A compiled timed event file holds the
+ * same events as fixed size records (see timed_event_record in
+ * lib/iestream.hpp), which iestream_input maps into memory and
+ * reads without parsing.
+*/
+
+#ifndef __TIMED_EVENTS_HPP__
+#define __TIMED_EVENTS_HPP__
+
+#include <cstdint>
+
+/**
+ * Function that compiles a text input file to a timed event file.
+ * Times are stored in milliseconds, finer fields are truncated.
+ * Values must be integers from 0 to UINT32_MAX, as the messages
+ * read them; other lines are reported and skipped.
+ * @param fin text input file name string
+ * @param fout timed event file name string
+ * @return number of events written, or -1 if the files can not be opened
+*/
+int64_t compile_timed_events(char *fin, char *fout);
+
+#endif // __TIMED_EVENTS_HPP__
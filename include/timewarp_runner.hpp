@@ -0,0 +1,807 @@
+/** \brief This header file implements the timewarp_runner class.
+ *
+ * The Time Warp runner simulates a flat coupled model with several
+ * threads, optimistically. It is a model sink like the heap runner:
+ * models are added with add, coupled with couple and connected to
+ * the TOP outputs with output.
+ *
+ * The models are dealt to logical processes, one per thread, as the
+ * parallel runner deals them, by the connected components of their
+ * couplings. A source model, one without inputs, that is coupled to
+ * several models is not part of their component: it is put in the
+ * first process, and its couplings cross from one process to the
+ * others. This is the generator of an input file, which is shared
+ * by all channels. A model can also be put in a process with place,
+ * to split a component, as channels that share a repeater.
+ *
+ * Every process simulates its models as the heap runner does, with
+ * the messages of other processes in an input queue, without waiting
+ * for them: it simulates the events of its next time, steps ahead
+ * and sends the messages for other processes to their mailboxes. A
+ * message for a time the process has already simulated, a straggler,
+ * rolls the process back: the steps from that time on are undone and
+ * simulated again with it. Before every transition the state of the
+ * model is copied into its ring of saved states, and a rollback
+ * copies them back, newest first. The messages sent by the undone
+ * steps are cancelled lazily: the steps simulated again send them
+ * again, and only the ones that are not sent again, or are sent with
+ * another value, are cancelled by anti-messages, which remove them
+ * from the input queue of their process, rolling it back if it has
+ * used them. Processes that receive no messages of other processes
+ * are never rolled back, and save no states.
+ *
+ * The processes run in rounds of a batch of steps each. Between the
+ * rounds the global virtual time (GVT), the earliest time of the
+ * next steps and of the messages in the mailboxes, is computed. No
+ * step before the GVT can be rolled back any more, so their saved
+ * states and inputs are released, fossil collection, and their log
+ * records are logged as the parallel runner logs them. The steps of
+ * a round are at most the given window past the GVT.
+ *
+ * The outputs of a model at a time are computed from its state
+ * before the transitions at that time, so the steps simulated again
+ * after a rollback send the same messages, and the log is that of
+ * the heap runner with any number of threads. A message between
+ * processes is known by its time, its model and its position in the
+ * output of the model, so a model coupled to another process must
+ * not output twice at the same time.
+ *
+ * All ports must carry Message_t.
+*/
+
+#ifndef __TIMEWARP_RUNNER_HPP__
+#define __TIMEWARP_RUNNER_HPP__
+
+#include <stdint.h>
+#include <algorithm>
+#include <assert.h>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "message.hpp"
+#include "heap_runner.hpp"
+#include "parallel_runner.hpp"
+
+#define TIMEWARP_BATCH 256
+
+/**
+ * The warp_model class is the interface of the Time Warp runner to
+ * an atomic model, with a ring of saved states.
+*/
+template<typename TIME>
+class warp_model : public heap_model<TIME> {
+    public:
+        using heap_model<TIME>::heap_model;
+
+        /** Function that saves a copy of the state, the newest. */
+        virtual void save() = 0;
+        /** Function that restores the newest saved state. */
+        virtual void restore() = 0;
+        /** Function that releases the oldest saved state. */
+        virtual void discard() = 0;
+};
+
+/**
+ * The warp_atomic class adapts an atomic model to warp_model. States
+ * that can not be copied, as the parser of iestream_input, can not
+ * be saved; these models must not be rolled back.
+*/
+template<template<typename> class MODEL, typename TIME>
+class warp_atomic : public heap_atomic<MODEL, TIME, warp_model<TIME>> {
+    using state_type = typename MODEL<TIME>::state_type;
+    static constexpr bool SAVES = std::is_copy_constructible<state_type>::value &&
+        std::is_copy_assignable<state_type>::value;
+
+    public:
+        using heap_atomic<MODEL, TIME, warp_model<TIME>>::heap_atomic;
+
+        void save() override {
+            if constexpr (SAVES) {
+                _saved.push_back(this->_model.state);
+            }
+            else {
+                assert(false && "state of a rolled back model is copied");
+            }
+        }
+
+        void restore() override {
+            if constexpr (SAVES) {
+                this->_model.state = _saved.back();
+                _saved.pop_back();
+            }
+        }
+
+        void discard() override {
+            _saved.pop_front();
+        }
+
+    private:
+        std::deque<state_type> _saved;
+};
+
+/**
+ * Structure that identifies a message between processes: its time,
+ * the model that sent it, its position in the output of the model
+ * and the coupling it took. The messages of a model are received in
+ * the order of their keys, which is the order of the heap runner.
+*/
+template<typename TIME>
+struct warp_key {
+    TIME time;
+    size_t source;
+    uint32_t out;
+    uint32_t route;
+
+    bool operator<(const warp_key &o) const {
+        if (time < o.time) {
+            return true;
+        }
+        if (o.time < time) {
+            return false;
+        }
+        return std::tie(source, out, route) <
+            std::tie(o.source, o.out, o.route);
+    }
+};
+
+/**
+ * Structure that holds a message between processes.
+*/
+template<typename TIME>
+struct warp_message {
+    warp_key<TIME> key;
+    size_t to;          //!< Model that receives it.
+    int port;           //!< Input port of the model.
+    Message_t value;
+    bool anti;          //!< Cancels the message with the same key.
+
+    bool same(const warp_message &o) const {
+        return to == o.to && port == o.port && value.seq == o.value.seq &&
+            value.session == o.value.session &&
+            value.length == o.value.length && value.kind == o.value.kind &&
+            value.bit == o.value.bit;
+    }
+};
+
+/**
+ * The timewarp_runner class simulates a flat coupled model in
+ * optimistic logical processes.
+*/
+template<typename TIME, typename LOGGER>
+class timewarp_runner {
+    public:
+        /**
+         * Constructor of the runner.
+         * @param threads number of threads, 0 for one per core
+         * @param window how far past the GVT the processes step ahead
+        */
+        timewarp_runner(unsigned threads, const TIME &window) :
+            _threads(threads ? threads : std::thread::hardware_concurrency()),
+            _window(window) {
+            if (_threads == 0) {
+                _threads = 1;
+            }
+        }
+
+        /**
+         * Function that adds an atomic model. It is built by the
+         * thread of its process when the simulation starts.
+         * @param name model name
+         * @param args arguments of the constructor of the model
+        */
+        template<template<typename> class MODEL, typename... ARGS>
+        void add(const std::string &name, ARGS... args) {
+            assert(!_started && "models are added before the run");
+            _index.emplace(name, _names.size());
+            _names.push_back(name);
+            _factories.push_back([name, args...]() {
+                return std::unique_ptr<warp_model<TIME>>(
+                    new warp_atomic<MODEL, TIME>(name, args...));
+            });
+        }
+
+        /**
+         * Function that couples an output port of a model to an
+         * input port of another one.
+        */
+        template<typename FROM_PORT, typename TO_PORT>
+        void couple(const std::string &from, const std::string &to) {
+            assert(!_started && "models are coupled before the run");
+            _couplings.push_back({from, to, typeid(FROM_PORT),
+                                  typeid(TO_PORT)});
+        }
+
+        /**
+         * Function that connects an output port of a model to an
+         * output port of the TOP model, which goes nowhere.
+        */
+        template<typename FROM_PORT, typename TO_PORT>
+        void output(const std::string &) {
+        }
+
+        /**
+         * Function that puts a model in a process, instead of the
+         * process of its component. The models that receive messages
+         * of other processes are rolled back, so their states must
+         * be copyable.
+         * @param name model name
+         * @param process index of the process
+        */
+        void place(const std::string &name, size_t process) {
+            assert(!_started && "models are placed before the run");
+            _placed.emplace_back(name, process);
+        }
+
+        /** @return number of models */
+        size_t models() const { return _names.size(); }
+
+        /** @return number of processes, known after the start */
+        size_t processes() const { return _processes.size(); }
+
+        /** @return steps simulated, including those rolled back */
+        uint64_t steps() const { return sum(&process::steps); }
+
+        /** @return steps undone by rollbacks */
+        uint64_t rolled_back() const { return sum(&process::rolled_back); }
+
+        /** @return anti-messages sent */
+        uint64_t anti_messages() const { return sum(&process::antis); }
+
+        /**
+         * Function that deals the models to the processes, starts
+         * the threads and starts the simulation at the initial time.
+         * @param initial_time time of the start
+        */
+        void start(const TIME &initial_time) {
+            _started = true;
+            build_processes();
+            _pool.start(_processes.size(),
+                [this](size_t p, int c) { execute(p, (command) c); });
+            _pool.run((int) command::build);
+            resolve_couplings();
+            _initial = initial_time;
+            _pool.run((int) command::start);
+        }
+
+        /**
+         * Function that simulates the events before time t.
+         * @param t time to simulate until
+         * @return time of the next event
+        */
+        TIME run_until(const TIME &t) {
+            if (!_started) {
+                start(TIME());
+            }
+            for (;;) {
+                TIME gvt = global_virtual_time();
+                commit(gvt);
+                if (!(gvt < t)) {
+                    return gvt;
+                }
+                _limit = gvt + _window;
+                if (t < _limit) {
+                    _limit = t;
+                }
+                _pool.run((int) command::advance);
+            }
+        }
+
+    private:
+        enum class command { build, start, advance };
+
+        using route = std::pair<size_t, int>;   //!< Model and input port.
+
+        /**
+         * Structure that holds a coupling until the models are known.
+        */
+        struct coupling {
+            std::string from;
+            std::string to;
+            std::type_index from_port;
+            std::type_index to_port;
+        };
+
+        /**
+         * Structure that holds an input of a model in a step.
+        */
+        struct input {
+            warp_key<TIME> key;
+            int port;
+            Message_t value;
+        };
+
+        /**
+         * Structure that holds a step of a process until the GVT
+         * passes it: the saved states, with the time of the last
+         * transition of their models, and the messages sent.
+        */
+        struct step_record {
+            TIME time;
+            size_t first_record;   //!< First log record of the step.
+            std::vector<std::pair<size_t, TIME>> saved;
+            std::vector<warp_message<TIME>> sent;
+        };
+
+        /**
+         * Structure that holds a logical process.
+        */
+        struct process {
+            std::vector<size_t> global;   //!< Models, by local index.
+            std::vector<std::unique_ptr<warp_model<TIME>>> models;
+            std::vector<std::vector<std::vector<route>>> routes;
+            std::vector<TIME> last;
+            std::vector<std::vector<input>> inbox;
+            std::vector<bool> is_imminent;
+            event_heap<TIME> events;
+            bool saves = false;   //!< Receives messages, so rolls back.
+
+            std::map<warp_key<TIME>, warp_message<TIME>> queue;
+            std::map<warp_key<TIME>, warp_message<TIME>> cancelled;
+            std::mutex mailbox_mutex;
+            std::vector<warp_message<TIME>> mailbox;
+            std::vector<warp_message<TIME>> received;
+
+            std::deque<step_record> history;   //!< Steps after the GVT.
+            window_log<TIME> log;
+            bool has_lvt = false;   //!< A step was simulated.
+            TIME lvt;               //!< Time of the last step.
+            bool has_committed = false;
+            TIME committed;         //!< Time of the last step before the GVT.
+
+            std::vector<size_t> imminent;
+            std::vector<size_t> active;
+            heap_messages outbox;
+            heap_messages bag;
+            uint64_t steps = 0;
+            uint64_t rolled_back = 0;
+            uint64_t antis = 0;
+        };
+
+        unsigned _threads;
+        TIME _window;
+        bool _started = false;
+        TIME _initial;
+        TIME _limit;   //!< Steps of the round are before it.
+
+        std::vector<std::string> _names;
+        std::unordered_map<std::string, size_t> _index;
+        std::vector<std::function<std::unique_ptr<warp_model<TIME>>()>>
+            _factories;
+        std::vector<coupling> _couplings;
+        std::vector<std::pair<std::string, size_t>> _placed;
+        std::vector<size_t> _owner;   //!< Process of every model.
+        std::vector<size_t> _local;   //!< Index in its process.
+        std::vector<std::unique_ptr<process>> _processes;
+
+        window_merger<TIME, LOGGER> _merger{_names};
+        std::vector<window_log<TIME> *> _logs;
+        std::vector<size_t> _ends;
+        round_threads _pool;   //!< Declared last, stopped first.
+
+        size_t model_index(const std::string &name) const {
+            auto it = _index.find(name);
+            assert(it != _index.end() && "coupled model added");
+            return it->second;
+        }
+
+        uint64_t sum(uint64_t process::*counter) const {
+            uint64_t total = 0;
+            for (const std::unique_ptr<process> &p : _processes) {
+                total += (*p).*counter;
+            }
+            return total;
+        }
+
+        static TIME next_time(const TIME &t, const TIME &advance) {
+            return advance == std::numeric_limits<TIME>::infinity() ?
+                advance : t + advance;
+        }
+
+        /**
+         * Function that deals the models to the processes, with the
+         * sources coupled to several models in the first one.
+        */
+        void build_processes() {
+            size_t n = _names.size();
+            std::vector<size_t> inputs(n, 0);
+            std::vector<std::vector<size_t>> targets(n);
+            for (const coupling &c : _couplings) {
+                size_t to = model_index(c.to);
+                inputs[to]++;
+                targets[model_index(c.from)].push_back(to);
+            }
+            std::vector<bool> shared(n, false);
+            for (size_t m = 0; m < n; m++) {
+                std::sort(targets[m].begin(), targets[m].end());
+                shared[m] = inputs[m] == 0 && targets[m].size() > 1 &&
+                    targets[m].front() != targets[m].back();
+            }
+            std::vector<std::pair<size_t, size_t>> links;
+            for (const coupling &c : _couplings) {
+                size_t from = model_index(c.from);
+                if (!shared[from]) {
+                    links.emplace_back(from, model_index(c.to));
+                }
+            }
+            size_t count = deal_components(n, links, _threads, _owner);
+            for (size_t m = 0; m < n; m++) {
+                if (shared[m]) {
+                    _owner[m] = 0;
+                }
+            }
+            for (const std::pair<std::string, size_t> &placed : _placed) {
+                _owner[model_index(placed.first)] = placed.second;
+                count = std::max(count, placed.second + 1);
+            }
+
+            for (size_t p = 0; p < count; p++) {
+                _processes.push_back(std::make_unique<process>());
+                _logs.push_back(&_processes[p]->log);
+            }
+            _local.assign(n, 0);
+            for (size_t m = 0; m < n; m++) {
+                process &lp = *_processes[_owner[m]];
+                _local[m] = lp.global.size();
+                lp.global.push_back(m);
+            }
+            for (const coupling &c : _couplings) {
+                size_t from = model_index(c.from);
+                size_t to = model_index(c.to);
+                if (_owner[from] != _owner[to]) {
+                    _processes[_owner[to]]->saves = true;
+                }
+            }
+        }
+
+        /**
+         * Function that builds the routes of the processes from
+         * the couplings, once the models are built.
+        */
+        void resolve_couplings() {
+            for (const coupling &c : _couplings) {
+                size_t from = model_index(c.from);
+                size_t to = model_index(c.to);
+                process &source = *_processes[_owner[from]];
+                size_t m = _local[from];
+                int out = source.models[m]->output_port(c.from_port);
+                int in = _processes[_owner[to]]->models[_local[to]]->
+                    input_port(c.to_port);
+                assert(out >= 0 && in >= 0 && "port of the model");
+                if ((size_t) out >= source.routes[m].size()) {
+                    source.routes[m].resize(out + 1);
+                }
+                source.routes[m][out].emplace_back(to, in);
+            }
+            _couplings.clear();
+        }
+
+        void execute(size_t p, command what) {
+            process &lp = *_processes[p];
+            if (what == command::build) {
+                for (size_t m : lp.global) {
+                    lp.models.push_back(_factories[m]());
+                }
+                lp.routes.resize(lp.models.size());
+            }
+            else if (what == command::start) {
+                size_t n = lp.models.size();
+                lp.last.assign(n, _initial);
+                lp.inbox.assign(n, std::vector<input>());
+                lp.is_imminent.assign(n, false);
+                lp.log.time(_initial);
+                for (size_t m = 0; m < n; m++) {
+                    lp.log.model(window_record_kind::state, _initial,
+                                 lp.global[m], lp.models[m]->state_text());
+                    lp.events.push(next_time(_initial,
+                                             lp.models[m]->time_advance()));
+                }
+            }
+            else {
+                advance(lp);
+            }
+        }
+
+        /**
+         * Function that simulates a batch of steps of a process
+         * before the limit of the round.
+        */
+        void advance(process &lp) {
+            for (unsigned i = 0; i < TIMEWARP_BATCH; i++) {
+                receive(lp);
+                TIME next = next_step(lp);
+                cancel(lp, next, false);
+                if (!(next < _limit)) {
+                    break;
+                }
+                step(lp, next);
+            }
+            receive(lp);
+        }
+
+        /** @return time of the next step of a process */
+        TIME next_step(const process &lp) const {
+            TIME next = lp.events.empty() ?
+                std::numeric_limits<TIME>::infinity() : lp.events.top_time();
+            auto it = lp.has_lvt ? lp.queue.upper_bound({lp.lvt,
+                std::numeric_limits<size_t>::max(),
+                std::numeric_limits<uint32_t>::max(),
+                std::numeric_limits<uint32_t>::max()}) : lp.queue.begin();
+            if (it != lp.queue.end() && it->first.time < next) {
+                next = it->first.time;
+            }
+            return next;
+        }
+
+        void send(const warp_message<TIME> &message) {
+            process &to = *_processes[_owner[message.to]];
+            std::lock_guard<std::mutex> lock(to.mailbox_mutex);
+            to.mailbox.push_back(message);
+        }
+
+        /**
+         * Function that takes the messages of the mailbox of a
+         * process into its input queue, rolling it back for every
+         * message at or before its last step.
+        */
+        void receive(process &lp) {
+            {
+                std::lock_guard<std::mutex> lock(lp.mailbox_mutex);
+                lp.received.swap(lp.mailbox);
+            }
+            for (const warp_message<TIME> &message : lp.received) {
+                if (lp.has_lvt && !(lp.lvt < message.key.time)) {
+                    rollback(lp, message.key.time);
+                }
+                if (message.anti) {
+                    lp.queue.erase(message.key);
+                }
+                else {
+                    bool added = lp.queue.emplace(message.key, message).second;
+                    assert(added && "message cancelled before it is sent again");
+                }
+            }
+            lp.received.clear();
+        }
+
+        /**
+         * Function that undoes the steps of a process at time t
+         * and after. Their messages are cancelled when they are not
+         * sent again.
+        */
+        void rollback(process &lp, const TIME &t) {
+            while (!lp.history.empty() && !(lp.history.back().time < t)) {
+                step_record &step = lp.history.back();
+                for (auto it = step.saved.rbegin(); it != step.saved.rend();
+                     ++it) {
+                    size_t m = it->first;
+                    lp.models[m]->restore();
+                    lp.last[m] = it->second;
+                    lp.events.update(m, next_time(lp.last[m],
+                        lp.models[m]->time_advance()));
+                }
+                for (const warp_message<TIME> &message : step.sent) {
+                    lp.cancelled.emplace(message.key, message);
+                }
+                lp.log.records.erase(lp.log.records.begin() +
+                    step.first_record, lp.log.records.end());
+                lp.history.pop_back();
+                lp.rolled_back++;
+            }
+            lp.has_lvt = lp.history.empty() ? lp.has_committed : true;
+            lp.lvt = lp.history.empty() ? lp.committed :
+                lp.history.back().time;
+        }
+
+        /**
+         * Function that sends the anti-messages of the cancelled
+         * messages before time t, or at t too, which are not sent again.
+        */
+        void cancel(process &lp, const TIME &t, bool at) {
+            while (!lp.cancelled.empty()) {
+                const TIME &time = lp.cancelled.begin()->first.time;
+                if (!(time < t) && !(at && time == t)) {
+                    return;
+                }
+                warp_message<TIME> anti = lp.cancelled.begin()->second;
+                anti.anti = true;
+                send(anti);
+                lp.antis++;
+                lp.cancelled.erase(lp.cancelled.begin());
+            }
+        }
+
+        /**
+         * Function that sends a message to another process, unless
+         * it was cancelled and is sent again the same.
+        */
+        void send_again(process &lp, const warp_message<TIME> &message) {
+            auto it = lp.cancelled.find(message.key);
+            if (it != lp.cancelled.end()) {
+                bool same = it->second.same(message);
+                if (!same) {
+                    warp_message<TIME> anti = it->second;
+                    anti.anti = true;
+                    send(anti);
+                    lp.antis++;
+                }
+                lp.cancelled.erase(it);
+                if (same) {
+                    return;
+                }
+            }
+            send(message);
+        }
+
+        /**
+         * Function that simulates the events of a process at time t,
+         * as the heap runner does.
+        */
+        void step(process &lp, const TIME &t) {
+            lp.history.emplace_back();
+            step_record &step = lp.history.back();
+            step.time = t;
+            step.first_record = lp.log.records.size();
+            lp.log.time(t);
+
+            lp.imminent.clear();
+            lp.events.imminent(t, lp.imminent);
+            std::sort(lp.imminent.begin(), lp.imminent.end());
+            lp.active.assign(lp.imminent.begin(), lp.imminent.end());
+
+            for (size_t m : lp.imminent) {
+                lp.outbox.clear();
+                lp.models[m]->output(lp.outbox);
+                if (lp.outbox.empty()) {
+                    continue;
+                }
+                lp.log.model(window_record_kind::messages, t, lp.global[m],
+                             lp.models[m]->output_text(lp.outbox));
+                for (size_t i = 0; i < lp.outbox.size(); i++) {
+                    const auto &message = lp.outbox[i];
+                    if ((size_t) message.first >= lp.routes[m].size()) {
+                        continue;
+                    }
+                    const std::vector<route> &routes =
+                        lp.routes[m][message.first];
+                    for (size_t r = 0; r < routes.size(); r++) {
+                        warp_key<TIME> key{t, lp.global[m], (uint32_t) i,
+                                           (uint32_t) r};
+                        size_t to = routes[r].first;
+                        if (_owner[to] == _owner[lp.global[m]]) {
+                            size_t d = _local[to];
+                            if (lp.inbox[d].empty()) {
+                                lp.active.push_back(d);
+                            }
+                            lp.inbox[d].push_back({key, routes[r].second,
+                                                   message.second});
+                            continue;
+                        }
+                        warp_message<TIME> sent{key, to, routes[r].second,
+                                                message.second, false};
+                        send_again(lp, sent);
+                        if (lp.saves) {
+                            step.sent.push_back(sent);
+                        }
+                    }
+                }
+            }
+            cancel(lp, t, true);
+
+            for (auto it = lp.queue.lower_bound({t, 0, 0, 0});
+                 it != lp.queue.end() && it->first.time == t; ++it) {
+                size_t d = _local[it->second.to];
+                if (lp.inbox[d].empty()) {
+                    lp.active.push_back(d);
+                }
+                lp.inbox[d].push_back({it->first, it->second.port,
+                                       it->second.value});
+            }
+
+            std::sort(lp.active.begin(), lp.active.end());
+            lp.active.erase(std::unique(lp.active.begin(), lp.active.end()),
+                            lp.active.end());
+            for (size_t m : lp.imminent) {
+                lp.is_imminent[m] = true;
+            }
+            for (size_t m : lp.active) {
+                std::vector<input> &inputs = lp.inbox[m];
+                std::sort(inputs.begin(), inputs.end(),
+                    [](const input &a, const input &b) {
+                        return a.key < b.key;
+                    });
+                lp.bag.clear();
+                for (const input &x : inputs) {
+                    lp.bag.emplace_back(x.port, x.value);
+                }
+                if (lp.saves) {
+                    lp.models[m]->save();
+                    step.saved.emplace_back(m, lp.last[m]);
+                }
+                TIME e = t - lp.last[m];
+                if (!lp.is_imminent[m]) {
+                    lp.models[m]->external_transition(e, lp.bag);
+                }
+                else if (lp.bag.empty()) {
+                    lp.models[m]->internal_transition();
+                }
+                else {
+                    lp.models[m]->confluence_transition(e, lp.bag);
+                }
+                lp.is_imminent[m] = false;
+                inputs.clear();
+                lp.last[m] = t;
+                lp.log.model(window_record_kind::state, t, lp.global[m],
+                             lp.models[m]->state_text());
+                lp.events.update(m, next_time(t,
+                    lp.models[m]->time_advance()));
+            }
+            lp.has_lvt = true;
+            lp.lvt = t;
+            lp.steps++;
+        }
+
+        /**
+         * Function that computes the GVT while the threads wait.
+        */
+        TIME global_virtual_time() {
+            TIME gvt = std::numeric_limits<TIME>::infinity();
+            for (const std::unique_ptr<process> &p : _processes) {
+                TIME next = next_step(*p);
+                if (next < gvt) {
+                    gvt = next;
+                }
+                if (!p->cancelled.empty() &&
+                    p->cancelled.begin()->first.time < gvt) {
+                    gvt = p->cancelled.begin()->first.time;
+                }
+                for (const warp_message<TIME> &message : p->mailbox) {
+                    if (message.key.time < gvt) {
+                        gvt = message.key.time;
+                    }
+                }
+            }
+            return gvt;
+        }
+
+        /**
+         * Function that releases the steps of every process before
+         * the GVT, fossil collection, and logs them.
+        */
+        void commit(const TIME &gvt) {
+            _ends.clear();
+            for (const std::unique_ptr<process> &p : _processes) {
+                process &lp = *p;
+                while (!lp.history.empty() && lp.history.front().time < gvt) {
+                    for (const auto &saved : lp.history.front().saved) {
+                        lp.models[saved.first]->discard();
+                    }
+                    lp.has_committed = true;
+                    lp.committed = lp.history.front().time;
+                    lp.history.pop_front();
+                }
+                size_t end = lp.history.empty() ? lp.log.records.size() :
+                    lp.history.front().first_record;
+                for (step_record &step : lp.history) {
+                    step.first_record -= end;
+                }
+                _ends.push_back(end);
+                lp.queue.erase(lp.queue.begin(),
+                               lp.queue.lower_bound({gvt, 0, 0, 0}));
+            }
+            _merger.merge(_logs, _ends);
+        }
+};
+
+#endif // __TIMEWARP_RUNNER_HPP__
@@ -0,0 +1,181 @@
+/** \brief This header file declares the binary event trace logger.
+ *
+ * The trace logger can be used in place of the text loggers of
+ * the simulator. Instead of writing every formatted line to a text
+ * stream, it writes one fixed size record per output message:
+ *
+ * time in milliseconds | model id | port id | Message_t fields
+ *
+ * The fields are taken from the messages when the runner logs them
+ * with the bag, as the heap runner does; otherwise the integer values
+ * of the formatted line are read back exactly. Empty message bags
+ * produce no record. Model and port names are
+ * written once, in name records that precede their first use.
+ * A time record marks the first output of every simulation step.
+ * The trace can be converted to the text log and to the *_proc.txt
+ * table produced by output_file_process.
+*/
+
+#ifndef __TRACE_LOGGER_HPP__
+#define __TRACE_LOGGER_HPP__
+
+#include <cadmium/logger/common_loggers.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "filter_logger.hpp"
+
+#define TRACE_MAGIC "ABPTRC02"
+
+#define TRACE_NAME_MODEL 0xFFFF  /**< record defines a model name */
+#define TRACE_NAME_PORT  0xFFFE  /**< record defines a port name */
+#define TRACE_TIME       0xFFFD  /**< record starts a simulation step */
+
+/**
+ * Structure of one trace record. Name records hold the name
+ * length in ticks and are followed by the name padded to a
+ * multiple of the record size.
+*/
+struct trace_record {
+    int64_t ticks;      //!< Time in milliseconds or length of the name.
+    uint16_t model;     //!< Model id or one of the TRACE_* markers.
+    uint16_t port;      //!< Port id or id defined by a name record.
+    uint32_t seq;       //!< Message_t seq.
+    uint16_t session;   //!< Message_t session.
+    uint16_t length;    //!< Message_t length.
+    uint8_t kind;       //!< Message_t kind.
+    uint8_t bit;        //!< Message_t bit.
+    uint16_t reserved;
+};
+static_assert(sizeof(trace_record) == 24, "trace records are 24 bytes");
+
+/**
+ * The trace_writer class writes trace records to a file.
+*/
+class trace_writer {
+    public:
+        /**
+         * Constructor that creates the trace file and writes its header.
+         * @param path trace file name string
+        */
+        explicit trace_writer(const char *path);
+        trace_writer(const trace_writer &) = delete;
+        trace_writer &operator=(const trace_writer &) = delete;
+        ~trace_writer();
+
+        /**
+         * Function that starts a simulation step.
+         * @param line formatted time, as in "00:00:10:000"
+        */
+        void time_line(std::string_view line);
+
+        /**
+         * Function that writes one record per message of a line
+         * formatted as "[port: {v, ...}, ...] generated by model X".
+         * @param line formatted message line
+        */
+        void message_line(std::string_view line);
+
+        /**
+         * Function that writes one record per message of a bag.
+         * @param model model name
+         * @param bag message bag with its messages and port names
+        */
+        void messages(std::string_view model, const message_bag_text &bag);
+
+        /**
+         * Function that writes the buffered records and closes the file.
+        */
+        void close();
+
+        /** @return number of records written */
+        uint64_t records() const { return _records; }
+
+    private:
+        uint16_t intern(std::unordered_map<std::string, uint16_t> &ids,
+                        std::string_view name, uint16_t marker);
+        void write_record(int64_t ticks, uint16_t model, uint16_t port,
+                          const Message_t &message = Message_t());
+        void start_step();
+        void flush();
+
+        int _fd;
+        std::vector<char> _buf;
+        std::unordered_map<std::string, uint16_t> _models;
+        std::unordered_map<std::string, uint16_t> _ports;
+        int64_t _ticks;
+        bool _step_written;
+        uint64_t _records;
+};
+
+/**
+ * The trace_logger class is a logger that writes to a trace_writer.
+ * It has the same parameters as cadmium::logger::logger, so it
+ * can be used in its place. Only the logger_global_time and
+ * logger_messages sources produce records. Bags logged as a
+ * message_bag_text are written from their messages, other bags
+ * are formatted first.
+ * SINK_PROVIDER::sink() must return the trace_writer.
+*/
+template<typename LOGGING_SOURCE, typename FORMATTER, typename SINK_PROVIDER>
+struct trace_logger {
+    template<typename DECLARED_SOURCE, typename INFO, typename... PARAMs>
+    static void log(const PARAMs&... ps) {
+        if constexpr (std::is_same<LOGGING_SOURCE, DECLARED_SOURCE>::value) {
+            if ((is_empty_bag_param(ps) || ...)) {
+                return;
+            }
+            if constexpr (std::is_same<LOGGING_SOURCE,
+                cadmium::logger::logger_global_time>::value) {
+                SINK_PROVIDER::sink().time_line(
+                    FORMATTER::template format<INFO>(ps...)());
+            }
+            else if constexpr (std::is_same<LOGGING_SOURCE,
+                cadmium::logger::logger_messages>::value) {
+                log_messages<INFO>(ps...);
+            }
+        }
+    }
+
+    private:
+        template<typename INFO, typename TIME>
+        static void log_messages(const TIME &t, const std::string &model,
+                                 const message_bag_text &bag) {
+            if (bag.messages != nullptr && bag.ports != nullptr) {
+                SINK_PROVIDER::sink().messages(model, bag);
+            }
+            else {
+                SINK_PROVIDER::sink().message_line(
+                    FORMATTER::template format<INFO>(t, model, bag)());
+            }
+        }
+
+        template<typename INFO, typename... PARAMs>
+        static void log_messages(const PARAMs&... ps) {
+            SINK_PROVIDER::sink().message_line(
+                FORMATTER::template format<INFO>(ps...)());
+        }
+};
+
+/**
+ * Function that converts the trace to the text log format.
+ * Lines of models that produced no output are not written.
+ * @param fin trace file name string
+ * @param fout output file name string
+*/
+void trace_to_text(char *fin, char *fout);
+
+/**
+ * Function that converts the trace to the table format
+ * written by output_file_process.
+ * @param fin trace file name string
+ * @param fout output file name string
+*/
+void trace_to_proc(char *fin, char *fout);
+
+#endif // __TRACE_LOGGER_HPP__
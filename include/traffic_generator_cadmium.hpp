@@ -0,0 +1,429 @@
+/** \brief This header file implements the TrafficGenerator class.
+ *
+ * The traffic generator replaces the generator that replays an
+ * input file with a synthetic workload of many concurrent sessions.
+ * Every session is an arrival process of its own:
+ *
+ * - poisson: arrivals with exponential inter-arrival times,
+ * - mmpp: a two state Markov modulated Poisson process, that is
+ *   a Poisson process whose rate switches between two values
+ *   after exponential times, which produces bursts,
+ * - trace: inter-arrival times and packet counts replayed from
+ *   a file, every session starting at a random point of it.
+ *
+ * Arrivals are generated lazily: only the next arrival of every
+ * session is kept, in a heap ordered by time. When an arrival is
+ * taken from the heap the next one of its session is drawn, so
+ * the memory used grows with the number of sessions and not
+ * with the number of arrivals. Every arrival is sent as a control
+ * message with its packet count, tagged with its session modulo
+ * 65536; the arrivals of one millisecond are sent together.
+*/
+
+#ifndef __TRAFFIC_GENERATOR_CADMIUM_HPP__
+#define __TRAFFIC_GENERATOR_CADMIUM_HPP__
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/message_bag.hpp>
+#include <limits>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <random>
+#include <vector>
+
+#include "message.hpp"
+#include "time_ticks.hpp"
+
+using namespace cadmium;
+using namespace std;
+
+/**
+ * Structure that holds the parameters of the workload. It is built
+ * from a spec of space separated key=value pairs, for example
+ * "sessions=1000 arrival=mmpp rate=0.01,1 switch=0.005,0.1 packets=1:5".
+ * Rates are per session and per second.
+*/
+struct traffic_spec {
+    enum class arrival_type { poisson, mmpp, trace };
+
+    uint32_t sessions = 1;                   //!< Number of sessions, at
+                                             //!< most one per Message_t tag.
+    arrival_type arrival = arrival_type::poisson;
+    double rate[2] = {0.01, 0.01};           //!< Arrival rates of both phases.
+    double phase_switch[2] = {0.0, 0.0};     //!< Rates of leaving each phase.
+    int packets_min = 1;                     //!< Packets of one arrival.
+    int packets_max = 1;
+    uint64_t seed = 1;                       //!< Seed of the generator.
+    std::string trace_path;                  //!< File of "gap_ms packets" lines.
+    std::vector<std::pair<double, int>> trace;
+
+    /**
+     * Function that reads the spec, and the trace file if any.
+     * @param text spec string
+     * @param error description of the first wrong parameter
+     * @return true if the spec is valid
+    */
+    bool parse(const char *text, std::string &error) {
+        std::istringstream in(text);
+        std::string item;
+        while (in >> item) {
+            size_t eq = item.find('=');
+            std::string key = item.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : item.substr(eq + 1);
+            bool ok = !value.empty();
+            if (key == "sessions") {
+                ok = ok && parse_number(value, sessions) && sessions > 0 &&
+                     sessions <= (uint32_t) UINT16_MAX + 1;
+            }
+            else if (key == "arrival") {
+                if (value == "poisson") {
+                    arrival = arrival_type::poisson;
+                }
+                else if (value == "mmpp") {
+                    arrival = arrival_type::mmpp;
+                }
+                else if (value == "trace") {
+                    arrival = arrival_type::trace;
+                }
+                else {
+                    ok = false;
+                }
+            }
+            else if (key == "rate") {
+                ok = ok && parse_pair(value, rate) && rate[0] >= 0 && rate[1] >= 0;
+            }
+            else if (key == "switch") {
+                ok = ok && parse_pair(value, phase_switch) &&
+                     phase_switch[0] >= 0 && phase_switch[1] >= 0;
+            }
+            else if (key == "packets") {
+                size_t colon = value.find(':');
+                ok = ok && parse_number(value.substr(0, colon), packets_min);
+                packets_max = packets_min;
+                if (ok && colon != std::string::npos) {
+                    ok = parse_number(value.substr(colon + 1), packets_max);
+                }
+                ok = ok && packets_min > 0 && packets_max >= packets_min;
+            }
+            else if (key == "seed") {
+                ok = ok && parse_number(value, seed);
+            }
+            else if (key == "trace") {
+                trace_path = value;
+            }
+            else {
+                ok = false;
+            }
+            if (!ok) {
+                error = "wrong traffic parameter " + item;
+                return false;
+            }
+        }
+        if (arrival == arrival_type::trace) {
+            return read_trace(error);
+        }
+        return true;
+    }
+
+    private:
+        template<typename T>
+        static bool parse_number(const std::string &text, T &number) {
+            std::istringstream in(text);
+            return (in >> number) && in.eof();
+        }
+
+        /**
+         * Function that reads "a" or "a,b"; a single value is used for both.
+        */
+        static bool parse_pair(const std::string &text, double pair[2]) {
+            size_t comma = text.find(',');
+            if (!parse_number(text.substr(0, comma), pair[0])) {
+                return false;
+            }
+            pair[1] = pair[0];
+            return comma == std::string::npos ||
+                   parse_number(text.substr(comma + 1), pair[1]);
+        }
+
+        bool read_trace(std::string &error) {
+            std::ifstream in(trace_path);
+            if (!in.is_open()) {
+                error = "the trace file " + trace_path + " can not be opened";
+                return false;
+            }
+            double gap;
+            int packets;
+            double total = 0;
+            trace.clear();
+            while (in >> gap >> packets) {
+                if (gap < 0 || packets <= 0) {
+                    error = "wrong line in the trace file " + trace_path;
+                    return false;
+                }
+                trace.emplace_back(gap, packets);
+                total += gap;
+            }
+            if (trace.empty() || total <= 0) {
+                error = "the trace file " + trace_path + " has no arrivals";
+                return false;
+            }
+            return true;
+        }
+};
+
+/**
+ * Structure that holds the output port.
+*/
+struct traffic_generator_defs {
+    struct out : public out_port<Message_t> {
+    };
+};
+
+/**
+ * The TrafficGenerator class sends the packet count of every
+ * arrival of all sessions as a control message.
+*/
+template<typename TIME>
+class TrafficGenerator {
+    /** putting definitions in context */
+    using defs = traffic_generator_defs;
+    public:
+        /**
+         * Next arrival of a session. Times are in milliseconds.
+        */
+        struct arrival {
+            double time;
+            uint32_t session;
+            bool operator>(const arrival &other) const {
+                return time > other.time;
+            }
+        };
+
+        /**
+         * State of one session.
+        */
+        struct session_type {
+            uint8_t phase;         //!< Phase of the MMPP.
+            double phase_end;      //!< Time the phase ends.
+            uint32_t trace_pos;    //!< Next line of the trace.
+            int packets;           //!< Packets of the next arrival.
+        };
+
+        /**
+         * Structure that holds the state variables.
+        */
+        struct state_type {
+            std::vector<session_type> sessions;
+            std::vector<arrival> heap;  //!< Next arrival of every session.
+            std::mt19937_64 rng;
+            int64_t now;                //!< Current time in milliseconds.
+            int64_t next;               //!< Time of the next output.
+            std::vector<Message_t> out; //!< Arrivals of the next output.
+            uint64_t arrivals;          //!< Arrivals sent so far.
+        };
+        state_type state;
+
+        /** ports definition */
+        using input_ports = std::tuple<>;
+        using output_ports = std::tuple<typename defs::out>;
+
+        /**
+         * Constructor for one Poisson session with default parameters.
+        */
+        TrafficGenerator() noexcept : TrafficGenerator(traffic_spec()) {
+        }
+
+        /**
+         * Constructor for TrafficGenerator class. Draws the first
+         * arrival of every session.
+         * @param spec parameters of the workload
+        */
+        TrafficGenerator(traffic_spec spec) noexcept : _spec(std::move(spec)) {
+            state.rng.seed(_spec.seed);
+            state.now = 0;
+            state.arrivals = 0;
+            state.sessions.resize(_spec.sessions);
+            state.heap.reserve(_spec.sessions);
+            for (uint32_t i = 0; i < _spec.sessions; i++) {
+                session_type &s = state.sessions[i];
+                s.phase = 0;
+                s.phase_end = 0;
+                s.trace_pos = 0;
+                double start = 0;
+                if (_spec.arrival == traffic_spec::arrival_type::mmpp) {
+                    /** start in a phase drawn from the stationary distribution */
+                    double total = _spec.phase_switch[0] + _spec.phase_switch[1];
+                    s.phase = total > 0 && uniform(state.rng) *
+                              total < _spec.phase_switch[0] ? 1 : 0;
+                    s.phase_end = exponential(_spec.phase_switch[s.phase]);
+                }
+                else if (_spec.arrival == traffic_spec::arrival_type::trace) {
+                    /** start at a random point of the trace */
+                    s.trace_pos = state.rng() % _spec.trace.size();
+                    start = -uniform(state.rng) * _spec.trace[s.trace_pos].first;
+                }
+                schedule(i, start);
+            }
+            std::make_heap(state.heap.begin(), state.heap.end(),
+                           std::greater<arrival>());
+            next_output();
+        }
+
+        /**
+         * Function that takes the arrivals of the next output
+         * from the heap.
+        */
+        void internal_transition() {
+            state.now = state.next;
+            next_output();
+        }
+
+        void external_transition(TIME e,
+            typename make_message_bags<input_ports>::type mbs) {
+            throw std::logic_error("External transition called in a model with no input ports");
+        }
+
+        void confluence_transition(TIME e,
+            typename make_message_bags<input_ports>::type mbs) {
+            throw std::logic_error("Confluence transition called in a model with no input ports");
+        }
+
+        /**
+         * Function that sends the packet count of every arrival.
+         * @return Message bags
+        */
+        typename make_message_bags<output_ports>::type output() const {
+            typename make_message_bags<output_ports>::type bags;
+            get_messages<typename defs::out>(bags) = state.out;
+            return bags;
+        }
+
+        /**
+         * Function that returns the time until the next arrival.
+         * @return Next internal time
+        */
+        TIME time_advance() const {
+            if (state.out.empty()) {
+                return std::numeric_limits<TIME>::infinity();
+            }
+            return ticks_to_time<TIME>(state.next - state.now);
+        }
+
+        /**
+         * Function that outputs the number of arrivals
+         * and sessions to ostring stream.
+         * @param os the ostring stream
+         * @param i structure state_type
+         * @return os the ostring stream
+        */
+        friend std::ostringstream& operator<<(std::ostringstream& os,
+            const typename TrafficGenerator<TIME>::state_type& i) {
+            os << "arrivals: " << i.arrivals << " & sessions: " << i.sessions.size();
+            return os;
+        }
+
+    private:
+        traffic_spec _spec;
+
+        static double uniform(std::mt19937_64 &rng) {
+            return std::generate_canonical<double, 64>(rng);
+        }
+
+        /**
+         * Function that draws an exponential time in milliseconds.
+         * @param rate rate per second
+        */
+        double exponential(double rate) {
+            if (rate <= 0) {
+                return std::numeric_limits<double>::infinity();
+            }
+            return -log(1.0 - uniform(state.rng)) * 1000.0 / rate;
+        }
+
+        /**
+         * Function that draws the next arrival of a session after the
+         * given time and appends it to the heap. Sessions that never
+         * send again are left out of the heap.
+         * @return true if an arrival was appended
+        */
+        bool schedule(uint32_t i, double after) {
+            session_type &s = state.sessions[i];
+            double time = after;
+            switch (_spec.arrival) {
+            case traffic_spec::arrival_type::poisson:
+                time += exponential(_spec.rate[0]);
+                break;
+            case traffic_spec::arrival_type::mmpp:
+                /**
+                 * the exponential is memoryless, so when the phase
+                 * ends first the arrival is drawn again from its end
+                */
+                while (true) {
+                    double gap = exponential(_spec.rate[s.phase]);
+                    if (time + gap <= s.phase_end) {
+                        time += gap;
+                        break;
+                    }
+                    if (s.phase_end == std::numeric_limits<double>::infinity()) {
+                        return false;
+                    }
+                    time = s.phase_end;
+                    s.phase ^= 1;
+                    s.phase_end = time + exponential(_spec.phase_switch[s.phase]);
+                }
+                break;
+            case traffic_spec::arrival_type::trace:
+                time += _spec.trace[s.trace_pos].first;
+                s.packets = _spec.trace[s.trace_pos].second;
+                s.trace_pos = (s.trace_pos + 1) % _spec.trace.size();
+                break;
+            }
+            if (time == std::numeric_limits<double>::infinity()) {
+                return false;
+            }
+            if (_spec.arrival != traffic_spec::arrival_type::trace) {
+                s.packets = _spec.packets_min;
+                if (_spec.packets_max > _spec.packets_min) {
+                    s.packets += state.rng() %
+                        (_spec.packets_max - _spec.packets_min + 1);
+                }
+            }
+            state.heap.push_back({std::max(time, 0.0), i});
+            return true;
+        }
+
+        /**
+         * Function that collects the arrivals of the next millisecond
+         * and draws the next arrival of their sessions.
+        */
+        void next_output() {
+            state.out.clear();
+            if (state.heap.empty()) {
+                return;
+            }
+            state.next = std::max<int64_t>(llround(state.heap.front().time), state.now);
+            while (!state.heap.empty() &&
+                   std::max<int64_t>(llround(state.heap.front().time), state.now) == state.next) {
+                std::pop_heap(state.heap.begin(), state.heap.end(),
+                              std::greater<arrival>());
+                arrival a = state.heap.back();
+                state.heap.pop_back();
+                state.out.push_back(Message_t::number(
+                    state.sessions[a.session].packets, (uint16_t) a.session));
+                state.arrivals++;
+                if (schedule(a.session, a.time)) {
+                    std::push_heap(state.heap.begin(), state.heap.end(),
+                                   std::greater<arrival>());
+                }
+            }
+        }
+};
+
+#endif // __TRAFFIC_GENERATOR_CADMIUM_HPP__
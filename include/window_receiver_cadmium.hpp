@@ -0,0 +1,214 @@
+/** \brief This header file implements the WindowReceiver class.
+ *
+ * The window receiver is the receiver of the WindowSender and has
+ * the ports of the Receiver. It reads the sequence number of every
+ * packet and sends an acknowledge PREPARATION_TIME later; packets
+ * that arrive meanwhile are acknowledged in turn, so the
+ * acknowledges are pipelined like the packets:
+ *
+ * - go_back_n: only the expected packet is accepted and every
+ *   packet is answered with the sequence number of the last packet
+ *   received in order,
+ * - selective_repeat: the packets of the window are buffered and
+ *   acknowledged on their own, and packets of the previous window
+ *   are acknowledged again.
+*/
+
+#ifndef __WINDOW_RECEIVER_CADMIUM_HPP__
+#define __WINDOW_RECEIVER_CADMIUM_HPP__
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/message_bag.hpp>
+#include <limits>
+#include <assert.h>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "message.hpp"
+#include "receiver_cadmium.hpp"
+#include "window_sender_cadmium.hpp"
+
+using namespace cadmium;
+using namespace std;
+
+/**
+ * The WindowReceiver class receives a window of messages
+ * and sends back acknowledges.
+*/
+template<typename TIME>
+class WindowReceiver {
+    /** putting definitions in context */
+    using defs = receiver_defs;
+    public:
+        TIME PREPARATION_TIME;    //!< Time delay from input to acknowledge.
+        int WINDOW;               //!< Packets buffered at most.
+        int SEQ_SPACE;            //!< Number of sequence numbers.
+        window_mode MODE;         //!< Retransmission strategy.
+
+        /**
+         * Constructor for WindowReceiver class.
+         * Go back N with a window of one packet.
+        */
+        WindowReceiver() noexcept : WindowReceiver(TIME("00:00:10"), 1, 2,
+            window_mode::go_back_n) {
+        }
+
+        /**
+         * Constructor for WindowReceiver class.
+         * @param preparation_time delay from input to acknowledge
+         * @param window packets buffered at most
+         * @param seq_space number of sequence numbers
+         * @param mode retransmission strategy
+        */
+        WindowReceiver(TIME preparation_time, int window, int seq_space,
+                       window_mode mode) noexcept {
+            assert(window > 0 && "window of one packet at least");
+            assert(seq_space >= window_min_seq_space(window, mode) &&
+                   "sequence number space too small for the window");
+            PREPARATION_TIME = preparation_time;
+            WINDOW           = window;
+            SEQ_SPACE        = seq_space;
+            MODE             = mode;
+            state.expected   = 1 % seq_space;
+            state.delivered  = 0;
+            state.now        = TIME();
+            state.received.assign(window, false);
+        }
+
+        /**
+         * Structure that holds the state variables.
+        */
+        struct state_type {
+            int expected;       //!< Sequence number expected in order.
+            int delivered;      //!< Packets received in order.
+            TIME now;           //!< Time of the last transition.
+            std::deque<bool> received;   //!< Window from expected on.
+            std::deque<std::pair<TIME, int>> acks;   //!< Time and number.
+        };
+        state_type state;
+
+        /** ports definition */
+        using input_ports = std::tuple<typename defs::in>;
+        using output_ports = std::tuple<typename defs::out>;
+
+        /**
+         * Function that performs the internal transition.
+         * It removes the acknowledge that was sent.
+        */
+        void internal_transition() {
+            state.now = state.acks.front().first;
+            state.acks.pop_front();
+        }
+
+        /**
+         * Function that performs external transition.
+         * Retrieves the messages: if the number of messages
+         * is more than 1, it asserts that only one message is
+         * expected per time unit. It then queues the acknowledge
+         * of the packet.
+         * @param e time variable
+         * @param mbs message bags
+        */
+        void external_transition(TIME e,
+            typename make_message_bags<input_ports>::type mbs) {
+            if (get_messages<typename defs::in>(mbs).size() > 1) {
+                assert(false && "one message per time uniti");
+            }
+            state.now = state.now + e;
+            for (const auto &x : get_messages<typename defs::in>(mbs)) {
+                int seq = x.seq;
+                int ack = MODE == window_mode::go_back_n ?
+                    receive_in_order(seq) : receive_selective(seq);
+                if (ack >= 0) {
+                    state.acks.emplace_back(state.now + PREPARATION_TIME,
+                                            ack);
+                }
+            }
+        }
+
+        /**
+         * Function that calls internal transition
+         * followed by external transition.
+         * @param e the first argument
+         * @param mbs the second argument
+        */
+        void confluence_transition(TIME e,
+            typename make_message_bags<input_ports>::type mbs) {
+            internal_transition();
+            external_transition(TIME(), std::move(mbs));
+        }
+
+        /**
+         * Function that sends the next acknowledge to the output port.
+         * @return Message bags
+        */
+        typename make_message_bags<output_ports>::type output() const {
+            typename make_message_bags<output_ports>::type bags;
+            get_messages<typename defs::out>(bags).push_back(
+                Message_t::number(state.acks.front().second));
+            return bags;
+        }
+
+        /**
+         * Function with no parameters that returns the time
+         * until the next acknowledge, or infinity if there is none.
+         * @return Next internal time
+        */
+        TIME time_advance() const {
+            if (state.acks.empty()) {
+                return std::numeric_limits<TIME>::infinity();
+            }
+            return state.acks.front().first - state.now;
+        }
+
+        /**
+         * Function that outputs the expected sequence number and
+         * the packets received in order to ostring stream.
+         * @param os the ostring stream
+         * @param i structure state_type
+         * @return os the ostring stream
+        */
+        friend std::ostringstream& operator<<(std::ostringstream& os,
+            const typename WindowReceiver<TIME>::state_type& i) {
+            os << "expected: " << i.expected << " & delivered: "
+               << i.delivered;
+            return os;
+        }
+
+    private:
+        /**
+         * Function that receives a packet with go back N.
+         * @return sequence number of the last packet in order
+        */
+        int receive_in_order(int seq) {
+            if (seq == state.expected) {
+                state.expected = (state.expected + 1) % SEQ_SPACE;
+                state.delivered++;
+            }
+            return (state.expected + SEQ_SPACE - 1) % SEQ_SPACE;
+        }
+
+        /**
+         * Function that receives a packet with selective repeat.
+         * @return sequence number to acknowledge, -1 for none
+        */
+        int receive_selective(int seq) {
+            int offset = (seq - state.expected + SEQ_SPACE) % SEQ_SPACE;
+            if (offset >= WINDOW) {
+                return offset >= SEQ_SPACE - WINDOW ? seq : -1;
+            }
+            state.received[offset] = true;
+            while (state.received.front()) {
+                state.received.pop_front();
+                state.received.push_back(false);
+                state.expected = (state.expected + 1) % SEQ_SPACE;
+                state.delivered++;
+            }
+            return seq;
+        }
+};
+
+#endif // __WINDOW_RECEIVER_CADMIUM_HPP__
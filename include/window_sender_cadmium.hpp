@@ -0,0 +1,395 @@
+/** \brief This header file implements the WindowSender class.
+ *
+ * The window sender is a pipelined variant of the Sender with the
+ * same ports. Up to WINDOW packets may be sent and not acknowledged
+ * yet. Every packet takes PREPARATION_TIME to be sent and carries
+ * its sequence number, the packet number modulo SEQ_SPACE, on the
+ * data output. Every packet sent has its own timeout:
+ *
+ * - go_back_n: the acknowledgements are cumulative and a timeout
+ *   sends again every packet of the window,
+ * - selective_repeat: every packet is acknowledged on its own and
+ *   a timeout sends again only that packet.
+ *
+ * Every packet sent, first transmissions and resends alike, and
+ * every packet acknowledged are output with their packet number
+ * and the session of their control message. Control messages
+ * received while the model is active add their packets after the
+ * packets still to be sent. The packet numbers continue across
+ * control messages, so the receiver keeps its sequence.
+*/
+
+#ifndef __WINDOW_SENDER_CADMIUM_HPP__
+#define __WINDOW_SENDER_CADMIUM_HPP__
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/message_bag.hpp>
+#include <limits>
+#include <assert.h>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "message.hpp"
+#include "sender_cadmium.hpp"
+
+using namespace cadmium;
+using namespace std;
+
+/**
+ * Retransmission strategy of the window models.
+*/
+enum class window_mode {
+    go_back_n,          //!< Cumulative acknowledgements.
+    selective_repeat    //!< Acknowledgements of single packets.
+};
+
+/**
+ * Function that returns the smallest sequence number space
+ * that tells the packets of a window apart.
+*/
+inline int window_min_seq_space(int window, window_mode mode) {
+    return mode == window_mode::go_back_n ? window + 1 : 2 * window;
+}
+
+/**
+ * The WindowSender class sends out a window of messages
+ * and receives acknowledges.
+*/
+template<typename TIME>
+class WindowSender {
+    /** putting definitions in context */
+    using defs = sender_defs;
+    public:
+        TIME PREPARATION_TIME;    //!< Time delay from one output to the next.
+        TIME TIMEOUT;             //!< Timeout delay from output to resend.
+        int WINDOW;               //!< Packets not acknowledged at most.
+        int SEQ_SPACE;            //!< Number of sequence numbers.
+        window_mode MODE;         //!< Retransmission strategy.
+
+        /**
+         * Constructor for WindowSender class.
+         * Go back N with a window of one packet, as the Sender.
+        */
+        WindowSender() noexcept : WindowSender(TIME("00:00:10"),
+            TIME("00:01:00"), 1, 2, window_mode::go_back_n) {
+        }
+
+        /**
+         * Constructor for WindowSender class.
+         * @param preparation_time delay from one output to the next
+         * @param timeout delay from output to resend
+         * @param window packets not acknowledged at most
+         * @param seq_space number of sequence numbers
+         * @param mode retransmission strategy
+        */
+        WindowSender(TIME preparation_time, TIME timeout, int window,
+                     int seq_space, window_mode mode) noexcept {
+            assert(window > 0 && "window of one packet at least");
+            assert(seq_space >= window_min_seq_space(window, mode) &&
+                   "sequence number space too small for the window");
+            PREPARATION_TIME = preparation_time;
+            TIMEOUT          = timeout;
+            WINDOW           = window;
+            SEQ_SPACE        = seq_space;
+            MODE             = mode;
+            state.total_packet_num = 0;
+            state.base             = 1;
+            state.next             = 1;
+            state.sending          = 0;
+            state.model_active     = false;
+            state.now              = TIME();
+            state.send_at          = std::numeric_limits<TIME>::infinity();
+            state.deadline.assign(window,
+                std::numeric_limits<TIME>::infinity());
+            state.acked.assign(window, false);
+        }
+
+        /**
+         * Structure that holds the state variables. The slot of
+         * packet p in deadline and acked is p modulo WINDOW.
+        */
+        struct state_type {
+            int total_packet_num;   //!< Last packet number to be sent.
+            int base;               //!< Oldest packet not acknowledged.
+            int next;               //!< Next packet sent for the first time.
+            int sending;            //!< Packet being prepared, 0 if none.
+            bool model_active;      //!< True - model is active.
+            TIME now;               //!< Time of the last transition.
+            TIME send_at;           //!< Time the prepared packet is sent.
+            std::vector<TIME> deadline;     //!< Timeout of every slot.
+            std::vector<bool> acked;        //!< Slot acknowledged.
+            std::deque<int> resend;         //!< Packets to send again.
+            std::vector<int> newly_acked;   //!< Acknowledges to output.
+            std::deque<std::pair<int, uint16_t>> arrivals;
+                                    //!< Last packet and session of every
+                                    //!< control message not acknowledged.
+        };
+        state_type state;
+
+        /** ports definition */
+        using input_ports = std::tuple<typename defs::control_in,
+            typename defs::ack_in>;
+        using output_ports = std::tuple<typename defs::packet_sent_out,
+        typename defs::ack_received_out, typename defs::data_out>;
+
+        /**
+         * Function that performs internal transition.
+         * The acknowledges are output first; otherwise the prepared
+         * packet is sent and its timeout starts, the expired
+         * timeouts queue their packets again and the next packet
+         * is prepared.
+        */
+        void internal_transition() {
+            TIME t = next_event();
+            state.now = t;
+            if (!state.newly_acked.empty()) {
+                state.newly_acked.clear();
+                while (!state.arrivals.empty() &&
+                       state.arrivals.front().first < state.base) {
+                    state.arrivals.pop_front();
+                }
+                return;
+            }
+            if (state.sending && state.send_at == t) {
+                state.deadline[state.sending % WINDOW] = t + TIMEOUT;
+                state.sending = 0;
+                state.send_at = std::numeric_limits<TIME>::infinity();
+            }
+            expire(t);
+            prepare_next();
+        }
+
+        /**
+         * Function that performs external transition.
+         * A control message adds its number of packets after the
+         * packets still to be sent. An acknowledge of a packet of
+         * the window acknowledges it, or every packet up to it
+         * with go back N; other acknowledges are ignored.
+         * @param e time variable
+         * @param mbs message bags
+        */
+        void external_transition(TIME e,
+            typename make_message_bags<input_ports>::type mbs) {
+            state.now = state.now + e;
+            for (const auto &x :
+                get_messages<typename defs::control_in>(mbs)) {
+                if (x.seq == 0) {
+                    continue;
+                }
+                if (state.model_active == false) {
+                    state.total_packet_num = state.next - 1;
+                    state.arrivals.clear();
+                    state.model_active = true;
+                }
+                state.total_packet_num += x.seq;
+                state.arrivals.emplace_back(state.total_packet_num,
+                                            x.session);
+                prepare_next();
+            }
+            for (const auto &x : get_messages<typename defs::ack_in>(mbs)) {
+                if (state.model_active == true) {
+                    acknowledge(x.seq);
+                    prepare_next();
+                }
+            }
+        }
+
+        /**
+         * Function that calls internal transition
+         * followed by external transition.
+         * @param e time variable
+         * @param mbs message bags
+        */
+        void confluence_transition(TIME e,
+            typename make_message_bags<input_ports>::type mbs) {
+            internal_transition();
+            external_transition(TIME(), std::move(mbs));
+        }
+
+        /**
+         * Function that sends the acknowledged packet numbers, or
+         * the sequence number and the packet number of the packet
+         * sent, to the output ports.
+         * @return Message bags
+        */
+        typename make_message_bags<output_ports>::type output() const {
+            typename make_message_bags<output_ports>::type bags;
+            if (!state.newly_acked.empty()) {
+                for (int p : state.newly_acked) {
+                    get_messages<typename defs::ack_received_out>(bags)
+                        .push_back(Message_t::number(p, session_of(p)));
+                }
+            }
+            else if (state.sending && state.send_at == next_event()) {
+                uint16_t session = session_of(state.sending);
+                get_messages<typename defs::data_out>(bags).push_back(
+                    Message_t::number(state.sending % SEQ_SPACE, session));
+                get_messages<typename defs::packet_sent_out>(bags).push_back(
+                    Message_t::number(state.sending, session));
+            }
+            return bags;
+        }
+
+        /**
+         * Function with no parameters that returns the next
+         * internal transition time.
+         * @return Next internal time
+        */
+        TIME time_advance() const {
+            TIME t = next_event();
+            if (t == std::numeric_limits<TIME>::infinity()) {
+                return t;
+            }
+            return t - state.now;
+        }
+
+        /**
+         * Function that outputs the window and
+         * total packet number to ostring stream.
+         * @param os the ostring stream
+         * @param i structure state_type
+         * @return os the ostring stream
+        */
+        friend std::ostringstream& operator<<(std::ostringstream& os,
+            const typename WindowSender<TIME>::state_type& i) {
+            os << "base: " << i.base << " & next: " << i.next <<
+                " & totalPacketNum: " << i.total_packet_num;
+            return os;
+        }
+
+    private:
+        /**
+         * Function that returns the session of a packet, that is
+         * the session of the control message that added it.
+        */
+        uint16_t session_of(int p) const {
+            for (const auto &a : state.arrivals) {
+                if (p <= a.first) {
+                    return a.second;
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * Function that returns the time of the next event:
+         * now if acknowledges are to be output, otherwise the
+         * earliest of the send time and the timeouts.
+        */
+        TIME next_event() const {
+            if (!state.newly_acked.empty()) {
+                return state.now;
+            }
+            TIME t = state.send_at;
+            for (int p = state.base; p < state.next; p++) {
+                if (state.deadline[p % WINDOW] < t) {
+                    t = state.deadline[p % WINDOW];
+                }
+            }
+            return t;
+        }
+
+        /**
+         * Function that queues again the packets whose timeout
+         * expired at time t.
+        */
+        void expire(TIME t) {
+            for (int p = state.base; p < state.next; p++) {
+                if (state.deadline[p % WINDOW] > t) {
+                    continue;
+                }
+                if (MODE == window_mode::selective_repeat) {
+                    state.deadline[p % WINDOW] =
+                        std::numeric_limits<TIME>::infinity();
+                    state.resend.push_back(p);
+                    continue;
+                }
+                state.resend.clear();
+                for (int q = state.base; q < state.next; q++) {
+                    state.deadline[q % WINDOW] =
+                        std::numeric_limits<TIME>::infinity();
+                    if (q != state.sending) {
+                        state.resend.push_back(q);
+                    }
+                }
+                return;
+            }
+        }
+
+        /**
+         * Function that acknowledges the packet of the window
+         * with a sequence number.
+        */
+        void acknowledge(int seq) {
+            int p = state.base;
+            while (p < state.next && p % SEQ_SPACE != seq) {
+                p++;
+            }
+            if (p == state.next) {
+                return;
+            }
+            if (MODE == window_mode::go_back_n) {
+                for (int q = state.base; q <= p; q++) {
+                    state.deadline[q % WINDOW] =
+                        std::numeric_limits<TIME>::infinity();
+                    state.newly_acked.push_back(q);
+                }
+                state.base = p + 1;
+            }
+            else if (!state.acked[p % WINDOW]) {
+                state.acked[p % WINDOW] = true;
+                state.deadline[p % WINDOW] =
+                    std::numeric_limits<TIME>::infinity();
+                state.newly_acked.push_back(p);
+                while (state.base < state.next &&
+                       state.acked[state.base % WINDOW]) {
+                    state.base++;
+                }
+            }
+            if (state.sending && (state.sending < state.base ||
+                state.acked[state.sending % WINDOW])) {
+                state.sending = 0;
+                state.send_at = std::numeric_limits<TIME>::infinity();
+            }
+        }
+
+        /**
+         * Function that prepares the next packet to be sent: a
+         * packet to send again first, otherwise a new packet if the
+         * window has room. The model turns passive when every
+         * packet is acknowledged.
+        */
+        void prepare_next() {
+            if (state.sending) {
+                return;
+            }
+            while (!state.resend.empty() &&
+                   (state.resend.front() < state.base ||
+                    state.acked[state.resend.front() % WINDOW])) {
+                state.resend.pop_front();
+            }
+            if (!state.resend.empty()) {
+                state.sending = state.resend.front();
+                state.resend.pop_front();
+            }
+            else if (state.next <= state.total_packet_num &&
+                     state.next < state.base + WINDOW) {
+                state.sending = state.next++;
+                state.deadline[state.sending % WINDOW] =
+                    std::numeric_limits<TIME>::infinity();
+                state.acked[state.sending % WINDOW] = false;
+            }
+            else {
+                if (state.base > state.total_packet_num) {
+                    state.model_active = false;
+                }
+                return;
+            }
+            state.send_at = state.now + PREPARATION_TIME;
+        }
+};
+
+#endif // __WINDOW_SENDER_CADMIUM_HPP__
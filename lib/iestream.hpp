@@ -32,9 +32,18 @@
 #include <limits>
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <string>
 #include <fstream>
+#include <vector>
+#include <sstream>
+#include <utility>
 
 
 using namespace std;
@@ -50,34 +59,203 @@ using namespace cadmium;
  * Data type MSG must have the operator >> in order to work. Data type TIME must also have the operator >> in order to work.
  * Each line must be an MSG. Therefore the operator >> cannot read inputs that are specified in multiple lines
  *
+ * The input may also be a timed event file compiled from the text format
+ * (see EVENT_COMPILE). The parser recognizes it by its magic number and reads
+ * its records from a memory mapping instead of parsing the text.
+ *
+*/
+
+#define TIMED_EVENT_MAGIC "ABPEVT02"
+
+/**
+ * Record of a compiled timed event file. The file starts with the magic
+ * number and the number of records, padded to the size of one record.
+ * MSG must be constructible from the value.
+*/
+struct timed_event_record {
+    int64_t ticks;      //!< Time of the event in milliseconds.
+    int64_t value;      //!< Integer value of the message.
+};
+static_assert(sizeof(timed_event_record) == 16, "timed event records are 16 bytes");
+
+/**
+ * Conversion of the milliseconds of a timed event record to TIME.
+ * TIME must be constructible from {hours, minutes, seconds, milliseconds},
+ * as NDTime is. Other time types can specialize it.
 */
+template<class TIME>
+struct timed_event_time {
+  static TIME from_ticks(int64_t ticks) {
+    return TIME({(int) (ticks / 3600000), (int) (ticks / 60000 % 60),
+                 (int) (ticks / 1000 % 60), (int) (ticks % 1000)});
+  }
+};
+
 
+#define PARSER_BATCH_SIZE 4096
 
+/**
+ * Result of reading the next timed input.
+ */
+enum class parse_status {
+  ok,            // an input was read
+  end_of_input,  // there are no more inputs
+  invalid_line   // the line could not be read as an input and is skipped
+};
+
+/**
+ * The Parser reads the inputs in batches of PARSER_BATCH_SIZE into a vector that is
+ * reused for every batch. The inputs of a batch are handed out by peek() and pop().
+ */
 template<class TIME, class INPUT>
 class Parser {
 private:
   std::ifstream file;
+  std::string text_line;
+  std::istringstream text_stream;
+  const char* events = nullptr;  // mapping of a compiled timed event file
+  size_t events_size = 0;
+  size_t events_pos = 0;
+  std::vector<std::pair<TIME,INPUT>> batch;
+  std::vector<size_t> batch_lines;
+  size_t batch_pos = 0;
+  size_t line_number = 0;
+  size_t invalid_line_number = 0;
+  size_t last_line = 0;
+  bool invalid = false;
+  bool input_ended = false;
 
 public:
   // Constructors
 
-  Parser() {}
+  Parser() {
+    batch.reserve(PARSER_BATCH_SIZE);
+    batch_lines.reserve(PARSER_BATCH_SIZE);
+  }
 
-  Parser(const char* file_path) {
+  Parser(const char* file_path) : Parser() {
     this->open_file(file_path);
   }
-  
+
+  Parser(const Parser&) = delete;
+  Parser& operator=(const Parser&) = delete;
+
+  ~Parser() {
+    if (events) munmap((void*) events, events_size);
+  }
+
   void open_file(const char* file_path) {
-    file.open(file_path);
+    if (!open_events(file_path)) file.open(file_path);
   }
 
-  std::pair<TIME,INPUT> next_timed_input() {
-    INPUT result;
+  /**
+   * Points event to the next timed input without consuming it. An invalid line is
+   * reported once, with its number in line(), and skipped by the next call.
+   */
+  parse_status peek(const std::pair<TIME,INPUT>*& event) {
+    if (batch_pos == batch.size()) {
+      if (invalid) {
+        invalid = false;
+        last_line = invalid_line_number;
+        return parse_status::invalid_line;
+      }
+      fill_batch();
+      if (batch.empty()) return parse_status::end_of_input;
+    }
+    event = &batch[batch_pos];
+    last_line = batch_lines[batch_pos];
+    return parse_status::ok;
+  }
+
+  /**
+   * Consumes the input returned by peek().
+   */
+  void pop() {
+    batch_pos++;
+  }
+
+  /**
+   * Reads the next timed input.
+   */
+  parse_status next_timed_input(std::pair<TIME,INPUT>& result) {
+    const std::pair<TIME,INPUT>* event;
+    parse_status status = peek(event);
+    if (status == parse_status::ok) {
+      result = *event;
+      pop();
+    }
+    return status;
+  }
+
+  /**
+   * Returns the line of the last input handed out, or of the last invalid line.
+   * In a timed event file it is the number of the record.
+   */
+  size_t line() const {
+    return last_line;
+  }
+
+private:
+  /**
+   * Reads the next batch of inputs. Reading stops before an invalid line, which is
+   * reported once the inputs before it are consumed.
+   */
+  void fill_batch() {
+    batch.clear();
+    batch_lines.clear();
+    batch_pos = 0;
+    if (input_ended) return;
+    if (events) {
+      timed_event_record record;
+      while (batch.size() < PARSER_BATCH_SIZE && events_pos + sizeof(record) <= events_size) {
+        memcpy(&record, events + events_pos, sizeof(record));
+        events_pos += sizeof(record);
+        batch.emplace_back(timed_event_time<TIME>::from_ticks(record.ticks), INPUT(record.value));
+        batch_lines.push_back(++line_number);
+      }
+      input_ended = batch.size() < PARSER_BATCH_SIZE;
+      return;
+    }
     TIME next_time;
-    if (file.eof()) throw std::exception();
-    file >> next_time;
-    file >> result;
-    return std::make_pair(next_time,result);
+    INPUT result;
+    while (batch.size() < PARSER_BATCH_SIZE) {
+      if (!std::getline(file, text_line)) {
+        input_ended = true;
+        break;
+      }
+      line_number++;
+      if (text_line.find_first_not_of(" \t\r") == std::string::npos) continue;
+      text_stream.clear();
+      text_stream.str(text_line);
+      if (!(text_stream >> next_time) || !(text_stream >> result)) {
+        invalid = true;
+        invalid_line_number = line_number;
+        break;
+      }
+      batch.emplace_back(next_time, result);
+      batch_lines.push_back(line_number);
+    }
+  }
+
+  bool open_events(const char* file_path) {
+    int fd = ::open(file_path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    char magic[8];
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(timed_event_record) ||
+        pread(fd, magic, sizeof(magic), 0) != (ssize_t) sizeof(magic) ||
+        memcmp(magic, TIMED_EVENT_MAGIC, sizeof(magic)) != 0) {
+      ::close(fd);
+      return false;
+    }
+    void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return false;
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+    events = (const char*) data;
+    events_size = st.st_size;
+    events_pos = sizeof(timed_event_record);
+    return true;
   }
 
 };
@@ -105,12 +283,10 @@ public:
     // state definition
     struct state_type{
         Parser<TIME, MSG> _parser;
-        MSG _last_input_read;
         vector<MSG> _next_input;
         TIME _simulation_time = TIME();
         TIME _next_time = TIME();
-        TIME _next_time2 = TIME();
-        bool _initialization = true;
+        bool _input_ended = false;
     }; 
 
     //The state._parser.open_file(parth_to_file) must be done in the model instantiation constructor
@@ -125,48 +301,42 @@ public:
         //out << "INTERNAL. IESTREAM " << endl;
         state._simulation_time += state._next_time;
         state._next_input.clear();
-        if(state._initialization){
-            state._initialization = false;
-            try {
-                std::pair<TIME, MSG> parsed_line = state._parser.next_timed_input();
-                state._next_time = parsed_line.first - state._simulation_time;
-                if (state._next_time < TIME({0})) throw std::exception();
-                state._last_input_read = parsed_line.second;
-                state._next_input.push_back(state._last_input_read);
-            } catch(std::exception& e) {
-                state._next_time = std::numeric_limits<TIME>::infinity();
-            }
-            try {
-                std::pair<TIME, MSG> parsed_line = state._parser.next_timed_input();
-                state._next_time2 = parsed_line.first - state._simulation_time;
-                if (state._next_time2 < TIME({0})) throw std::exception();
-                state._last_input_read = parsed_line.second;
-            } catch(std::exception& e) {
-                state._next_time2 = std::numeric_limits<TIME>::infinity();
-            }
-        }else{
-            state._next_time = state._next_time2 - state._next_time;
-            state._next_input.push_back(state._last_input_read);
-            try {
-                std::pair<TIME, MSG> parsed_line = state._parser.next_timed_input();
-                state._next_time2 = parsed_line.first - state._simulation_time;
-                if (state._next_time2 < TIME({0})) throw std::exception();
-                state._last_input_read = parsed_line.second;
-            } catch(std::exception& e) {
-                state._next_time2 = std::numeric_limits<TIME>::infinity();
-            }
+        const std::pair<TIME, MSG>* event;
+        if (!next_event(event)) {
+            state._next_time = std::numeric_limits<TIME>::infinity();
+            return;
         }
-        while(state._next_time == state._next_time2 & state._next_time != std::numeric_limits<TIME>::infinity()){
-            state._next_input.push_back(state._last_input_read);
-            try {
-                std::pair<TIME, MSG> parsed_line = state._parser.next_timed_input();
-                state._next_time2 = parsed_line.first - state._simulation_time;
-                if (state._next_time2 < TIME({0})) throw std::exception();
-                state._last_input_read = parsed_line.second;
-            } catch(std::exception& e) {
-                state._next_time2 = std::numeric_limits<TIME>::infinity();
+        TIME next_time = event->first;
+        state._next_time = next_time - state._simulation_time;
+        do {
+            state._next_input.push_back(event->second);
+            state._parser.pop();
+        } while (next_event(event) && event->first == next_time);
+    }
+
+    /**
+     * Points event to the next input of the parser. Invalid lines are reported and
+     * skipped. The input ends at its end or at the first input in the past.
+     */
+    bool next_event(const std::pair<TIME, MSG>*& event) {
+        while (!state._input_ended) {
+            switch (state._parser.peek(event)) {
+            case parse_status::ok:
+                if (event->first < state._simulation_time) {
+                    cout << "Input at line " << state._parser.line() << " is in the past, the rest of the input is ignored\n";
+                    state._input_ended = true;
+                    break;
+                }
+                return true;
+            case parse_status::invalid_line:
+                cout << "Line " << state._parser.line() << " of the input is not a timed input\n";
+                break;
+            case parse_status::end_of_input:
+                state._input_ended = true;
+                break;
             }
         }
+        return false;
     }
 
     // external transition
@@ -0,0 +1,200 @@
+/** \brief This source file defines the asynchronous log writer.
+ *
+ * Buffer i of the ring is filled by the simulator thread while
+ * head % buffers == i and written by the I/O thread while it is
+ * between tail and head. The simulator only waits when no buffer
+ * is free, and only sleeps on the condition variable then.
+*/
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "../include/async_writer.hpp"
+
+using namespace std;
+
+async_streambuf::async_streambuf(const char *path, backpressure policy,
+                                 size_t buffers, size_t buffer_size)
+    : _policy(policy), _buffers(max<size_t>(buffers, 2)),
+      _lengths(max<size_t>(buffers, 2)), _head(0), _tail(0),
+      _closing(false), _dropped_lines(0), _dropped_bytes(0), _blocked(0) {
+    _fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (_fd < 0) {
+        cout << "The file " << path
+             << " can not be opened for writing, errno = " << errno << "\n";
+        return;
+    }
+    for (auto &buffer : _buffers) {
+        buffer.resize(buffer_size);
+    }
+    setp(_buffers[0].data(), _buffers[0].data() + buffer_size);
+    _line_end = pbase();
+    _drop_from = pbase();
+    _continued = false;
+    _io = std::thread(&async_streambuf::io_loop, this);
+}
+
+async_streambuf::~async_streambuf() {
+    close();
+}
+
+void async_streambuf::close() {
+    if (_fd < 0) {
+        return;
+    }
+    if (pptr() != pbase()) {
+        publish();
+    }
+    {
+        lock_guard<mutex> lock(_mutex);
+        _closing = true;
+    }
+    _wake.notify_all();
+    _io.join();
+    ::close(_fd);
+    _fd = -1;
+    setp(nullptr, nullptr);
+}
+
+async_streambuf::int_type async_streambuf::overflow(int_type c) {
+    if (_fd < 0) {
+        return traits_type::eof();
+    }
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return traits_type::not_eof(c);
+    }
+    if (pptr() == epptr()) {
+        next_buffer();
+    }
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+}
+
+streamsize async_streambuf::xsputn(const char *s, streamsize n) {
+    if (_fd < 0) {
+        return 0;
+    }
+    streamsize done = 0;
+    while (done < n) {
+        if (pptr() == epptr()) {
+            next_buffer();
+        }
+        streamsize size = min<streamsize>(n - done, epptr() - pptr());
+        memcpy(pptr(), s + done, size);
+        pbump(size);
+        done += size;
+    }
+    return n;
+}
+
+int async_streambuf::sync() {
+    /**
+     * the loggers end every line with std::endl, so this is the
+     * end of a complete line; nothing is written to the file here
+    */
+    _line_end = pptr();
+    if (_continued) {
+        _drop_from = pptr();
+        _continued = false;
+    }
+    return 0;
+}
+
+bool async_streambuf::next_buffer() {
+    uint64_t buffers = _buffers.size();
+
+    /**
+     * the buffer after the current one is free
+     * once fewer than buffers - 1 are waiting
+    */
+    while (_head.load(memory_order_relaxed) -
+           _tail.load(memory_order_acquire) >= buffers - 1) {
+        if (_policy == backpressure::drop && _line_end > _drop_from) {
+            drop_lines();
+            return false;
+        }
+        _blocked++;
+        unique_lock<mutex> lock(_mutex);
+        _wake.wait(lock, [&]() {
+            return _head.load(memory_order_relaxed) -
+                   _tail.load(memory_order_acquire) < buffers - 1;
+        });
+    }
+    /**
+     * the first bytes of the next buffer complete the last line
+     * of this one if it is incomplete, they can not be dropped
+    */
+    _continued = _line_end != pptr();
+    publish();
+    auto &buffer = _buffers[_head.load(memory_order_relaxed) % buffers];
+    setp(buffer.data(), buffer.data() + buffer.size());
+    _line_end = pbase();
+    _drop_from = pbase();
+    return true;
+}
+
+void async_streambuf::publish() {
+    uint64_t head = _head.load(memory_order_relaxed);
+    _lengths[head % _buffers.size()] = pptr() - pbase();
+    _head.store(head + 1, memory_order_release);
+    {
+        lock_guard<mutex> lock(_mutex);
+    }
+    _wake.notify_all();
+}
+
+void async_streambuf::drop_lines() {
+    /**
+     * Drop the complete lines and keep the incomplete last one.
+     * The end of a line started in the previous buffer is kept.
+    */
+    size_t dropped = _line_end - _drop_from;
+    _dropped_lines += count(_drop_from, _line_end, '\n');
+    _dropped_bytes += dropped;
+    memmove(_drop_from, _line_end, pptr() - _line_end);
+    pbump(-static_cast<int>(dropped));
+    _line_end = _drop_from;
+}
+
+void async_streambuf::io_loop() {
+    uint64_t buffers = _buffers.size();
+    bool failed = false;
+
+    while (true) {
+        uint64_t tail = _tail.load(memory_order_relaxed);
+        if (tail == _head.load(memory_order_acquire)) {
+            unique_lock<mutex> lock(_mutex);
+            _wake.wait(lock, [&]() {
+                return _head.load(memory_order_acquire) != tail || _closing;
+            });
+            if (_head.load(memory_order_acquire) == tail) {
+                break;
+            }
+            continue;
+        }
+
+        const char *data = _buffers[tail % buffers].data();
+        size_t length = _lengths[tail % buffers];
+        size_t done = 0;
+        while (!failed && done < length) {
+            ssize_t size = write(_fd, data + done, length - done);
+            if (size < 0) {
+                cout << "The log can not be written, errno = " << errno << "\n";
+                failed = true;
+                break;
+            }
+            done += size;
+        }
+
+        _tail.store(tail + 1, memory_order_release);
+        {
+            lock_guard<mutex> lock(_mutex);
+        }
+        _wake.notify_all();
+    }
+}
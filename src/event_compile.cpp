@@ -0,0 +1,30 @@
+/** \brief This file contains main function for the timed event compiler.
+ *
+ * The compiler converts an input file of the generators, such as
+ * data/input/input_abp_1.txt, to a timed event file. The simulator
+ * accepts either file as its input.
+*/
+
+#include <iostream>
+
+#include "../include/timed_events.hpp"
+
+using namespace std;
+
+int main(int argc, char ** argv) {
+
+    if (argc < 3) {
+        cout << "you are using this program with wrong parameters."
+            << "The program should be invoked as follows:";
+        cout << argv[0] << " path to the input file"
+            << " path to the timed event file" << endl;
+        return 1;
+    }
+
+    int64_t events = compile_timed_events(argv[1], argv[2]);
+    if (events < 0) {
+        return 1;
+    }
+    cout << events << " events written to " << argv[2] << endl;
+    return 0;
+}
@@ -25,15 +25,426 @@
 #include <errno.h>
 #include <regex>
 #include <bits/stdc++.h> 
+#include <thread>
 #include <boost/algorithm/string.hpp>
 
 #include "../include/file_process.hpp"
 
 #define BUF_SIZE 2048
+#define STREAM_BUF_SIZE (1 << 20)
+#define MAP_WINDOW_SIZE (64 << 20)
+#define PARALLEL_CHUNK_SIZE (16 << 20)
 
 using namespace std;
 
+/**
+ * first line of the output file
+*/
+static const char TABLE_HEADER[] =
+    "Time           Value  Port                Component\n";
+
+/**
+ * separator between the port list and the name of component
+*/
+static const string_view MODEL_SEPARATOR = "] generated by model ";
+
+/**
+ * Function that appends the string left aligned and padded
+ * with spaces to the column width, same as setw() and left.
+*/
+static void append_column(string &out, string_view str, size_t width) {
+    out.append(str.data(), str.size());
+    if (str.size() < width) {
+        out.append(width - str.size(), ' ');
+    }
+}
+
+/**
+ * Function that checks if the line is a Time line,
+ * that is four groups of digits separated by colons.
+*/
+static bool is_time_line(string_view line) {
+    size_t i = 0;
+    for (int group = 0; group < 4; group++) {
+        size_t start = i;
+        while (i < line.size() && isdigit((unsigned char) line[i])) {
+            i++;
+        }
+        if (i == start) {
+            return false;
+        }
+        if (group < 3) {
+            if (i == line.size() || line[i] != ':') {
+                return false;
+            }
+            i++;
+        }
+    }
+    return i == line.size();
+}
+
+/**
+ * Function that outputs one item of the port list.
+ * The item is split the same way the regular expression
+ * "(.*)::(.*): {(.*)}" splits it: the port follows the last
+ * "::" and the value is enclosed by the last ": {" and the
+ * last "}". An item that does not match is used as both
+ * port and value.
+*/
+static void format_item(string_view item, string_view comp,
+                        const string &time, string &out) {
+    string_view port = item;
+    string_view value = item;
+    string_view suffix;
+    size_t k = item.rfind('}');
+    if (k != string_view::npos && k >= 3) {
+        size_t j = item.rfind(": {", k - 3);
+        if (j != string_view::npos && j >= 2) {
+            size_t i = item.rfind("::", j - 2);
+            if (i != string_view::npos) {
+                port = item.substr(i + 2, j - i - 2);
+                value = item.substr(j + 3, k - j - 3);
+                suffix = item.substr(k + 1);
+            }
+        }
+    }
+    /**
+     * text after the closing bracket is kept by the regular
+     * expression, so it is appended to both port and value
+    */
+    string port_buf;
+    string value_buf;
+    if (!suffix.empty()) {
+        port_buf.append(port).append(suffix);
+        value_buf.append(value).append(suffix);
+        port = port_buf;
+        value = value_buf;
+    }
+    if (!value.empty()) {
+        append_column(out, time, 15);
+        append_column(out, value, 7);
+        append_column(out, port, 20);
+        append_column(out, comp, 15);
+        out.push_back('\n');
+    }
+}
+
+void format_line(const char *line, size_t len, string &time, string &out) {
+    string_view str(line, len);
+
+    if (is_time_line(str)) {
+        time.assign(line, len);
+        return;
+    }
+
+    /**
+     * get the string in [] brackets and the name of component,
+     * any text before the opening bracket is kept in both
+    */
+    string_view port_str = str;
+    string_view comp = str;
+    string port_buf;
+    string comp_buf;
+    size_t q = str.rfind(MODEL_SEPARATOR);
+    size_t p = str.find('[');
+    if (q != string_view::npos && p < q) {
+        port_str = str.substr(p + 1, q - p - 1);
+        comp = str.substr(q + MODEL_SEPARATOR.size());
+        if (p > 0) {
+            port_buf.append(str.substr(0, p)).append(port_str);
+            comp_buf.append(str.substr(0, p)).append(comp);
+            port_str = port_buf;
+            comp = comp_buf;
+        }
+    }
+
+    /**
+     * split the string in [] brackets by comma
+    */
+    size_t start = 0;
+    while (true) {
+        size_t end = port_str.find(',', start);
+        if (end == string_view::npos) {
+            format_item(port_str.substr(start), comp, time, out);
+            break;
+        }
+        format_item(port_str.substr(start, end - start), comp, time, out);
+        start = end + 1;
+    }
+}
+
+/**
+ * Function that formats all lines of the view into the string.
+*/
+static void format_lines(const log_view &log, string &time, string &out) {
+    for (string_view line : log) {
+        format_line(line.data(), line.size(), time, out);
+    }
+}
+
+/**
+ * Function that finds the first Time line that starts at
+ * or after the offset. A line that contains the offset is
+ * skipped, as the offset may not be the start of the line.
+ * @return offset of the Time line or size if there is none
+*/
+static size_t next_time_line(const char *data, size_t size, size_t offset) {
+    if (offset == 0) {
+        return 0;
+    }
+    if (offset >= size) {
+        return size;
+    }
+    if (data[offset - 1] != '\n' && data[offset - 1] != '\r') {
+        while (offset < size && data[offset] != '\n' && data[offset] != '\r') {
+            offset++;
+        }
+    }
+    for (string_view line : log_view(data + offset, size - offset)) {
+        if (is_time_line(line)) {
+            return line.data() - data;
+        }
+    }
+    return size;
+}
+
+/**
+ * Function that formats all lines of the view and writes the rows
+ * to the output file in blocks of STREAM_BUF_SIZE bytes.
+*/
+static void format_view(const log_view &log, ofstream &out_file,
+                        string &time, string &out) {
+    for (string_view line : log) {
+        format_line(line.data(), line.size(), time, out);
+        if (out.size() >= STREAM_BUF_SIZE) {
+            out_file.write(out.data(), out.size());
+            out.clear();
+        }
+    }
+}
+
+/**
+ * Function that formats the file read block by block. It is used
+ * for files that can not be mapped, such as pipes and empty files.
+ * The incomplete line at the end of the block is moved to the
+ * beginning of the buffer and completed by the next block.
+ * The buffer only grows if a single line is longer than it.
+*/
+static void format_stream(char *fin, int fdi, ofstream &out_file,
+                          string &time, string &out) {
+    vector<char> buf(STREAM_BUF_SIZE);
+    size_t used = 0;
+    ssize_t size;
+
+    while ((size = read(fdi, buf.data() + used, buf.size() - used)) > 0) {
+        size_t end = used + size;
+        log_view block(buf.data(), end);
+        size_t line_start = end;
+        for (string_view line : block) {
+            /**
+             * the last line of the block may continue in the next block
+            */
+            if (line.data() + line.size() == buf.data() + end) {
+                line_start = line.data() - buf.data();
+                break;
+            }
+            format_line(line.data(), line.size(), time, out);
+        }
+        used = end - line_start;
+        memmove(buf.data(), buf.data() + line_start, used);
+        if (used == buf.size()) {
+            buf.resize(buf.size() * 2);
+        }
+        if (out.size() >= STREAM_BUF_SIZE) {
+            out_file.write(out.data(), out.size());
+            out.clear();
+        }
+    }
+    if (size < 0) {
+        cout << "The file " << fin << " can not be read from, errno = "
+             << errno << "\n";
+    }
+    if (used > 0) {
+        format_line(buf.data(), used, time, out);
+    }
+}
+
 void output_file_process(char *fin, char *fout) {
+    /**
+     * This function is to check if the read access to the input file is OK
+    */
+    if (access(fin, R_OK)) {
+        std::cout << "The file " << fin << " can not be read from, errno = "
+                  << errno << "\n";
+        return;
+    }
+
+    mapped_file file(fin);
+
+    /**
+     * the file is formatted straight from the mapped pages
+    */
+    if (file.is_open()) {
+        write_file(fout, file);
+        return;
+    }
+
+    int fdi = open(fin, O_RDONLY);
+    if (fdi < 0) {
+        cout << "The file " << fin
+             << " can not be opened for reading, errno = " << errno << "\n";
+        return;
+    }
+
+    ofstream out_file (fout);
+    if (out_file.is_open()) {
+        string out;
+        string time;
+        out.reserve(STREAM_BUF_SIZE + BUF_SIZE);
+        out.append(TABLE_HEADER);
+        format_stream(fin, fdi, out_file, time, out);
+        out_file.write(out.data(), out.size());
+    }
+    else {
+        cout << "The file " << fout
+             << " can not be opened for writing, errno = " << errno << "\n";
+    }
+
+    if (close(fdi) < 0) {
+        cout << "The file " << fin << " can not be closed\n";
+    }
+}
+
+void output_file_process(char *fin, char *fout, unsigned threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads <= 1) {
+        output_file_process(fin, fout);
+        return;
+    }
+
+    if (access(fin, R_OK)) {
+        std::cout << "The file " << fin << " can not be read from, errno = "
+                  << errno << "\n";
+        return;
+    }
+
+    mapped_file file(fin);
+
+    /**
+     * files that can not be mapped are formatted by a single thread
+    */
+    if (!file.is_open()) {
+        output_file_process(fin, fout);
+        return;
+    }
+
+    ofstream out_file (fout);
+    if (!out_file.is_open()) {
+        cout << "The file " << fout
+             << " can not be opened for writing, errno = " << errno << "\n";
+        return;
+    }
+    out_file << TABLE_HEADER;
+
+    /**
+     * The file is formatted in rounds of one chunk per thread.
+     * Every chunk except the first one starts on a Time line, so
+     * it does not depend on the previous chunk. The chunks of a
+     * round are written in order once all threads are done and
+     * their pages are released, so the resident memory stays at
+     * about one round.
+    */
+    const char *data = file.data();
+    size_t size = file.size();
+    vector<size_t> bounds(threads + 1);
+    vector<string> outs(threads);
+    vector<std::thread> workers;
+    size_t offset = 0;
+
+    while (offset < size) {
+        bounds[0] = offset;
+        for (unsigned i = 1; i <= threads; i++) {
+            bounds[i] = next_time_line(data, size, max(bounds[i - 1],
+                offset + (size_t) i * PARALLEL_CHUNK_SIZE));
+        }
+        for (unsigned i = 0; i < threads; i++) {
+            workers.emplace_back([&, i]() {
+                string time;
+                outs[i].clear();
+                format_lines(log_view(data + bounds[i],
+                    bounds[i + 1] - bounds[i]), time, outs[i]);
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+        for (const auto &out : outs) {
+            out_file.write(out.data(), out.size());
+        }
+        offset = bounds[threads];
+        file.release(offset);
+    }
+}
+
+void write_file(char *fout, const log_view &log) {
+    ofstream out_file (fout);
+
+    if (out_file.is_open()) {
+        string out;
+        string time;
+        out.reserve(STREAM_BUF_SIZE + BUF_SIZE);
+        out.append(TABLE_HEADER);
+        format_view(log, out_file, time, out);
+        out_file.write(out.data(), out.size());
+    }
+    else {
+        cout << "The file " << fout
+             << " can not be opened for writing, errno = " << errno << "\n";
+    }
+}
+
+void write_file(char *fout, const mapped_file &file) {
+    ofstream out_file (fout);
+
+    if (out_file.is_open()) {
+        string out;
+        string time;
+        out.reserve(STREAM_BUF_SIZE + BUF_SIZE);
+        out.append(TABLE_HEADER);
+
+        /**
+         * The file is formatted in windows ending on a line terminator.
+         * The pages of every formatted window are released, so the
+         * resident memory stays at about one window.
+        */
+        size_t offset = 0;
+        while (offset < file.size()) {
+            size_t end = offset + MAP_WINDOW_SIZE;
+            if (end >= file.size()) {
+                end = file.size();
+            }
+            else {
+                const char *nl = static_cast<const char *>(memchr(
+                    file.data() + end, '\n', file.size() - end));
+                end = nl == NULL ? file.size() : nl - file.data();
+            }
+            format_view(log_view(file.data() + offset, end - offset),
+                        out_file, time, out);
+            file.release(end);
+            offset = end;
+        }
+        out_file.write(out.data(), out.size());
+    }
+    else {
+        cout << "The file " << fout
+             << " can not be opened for writing, errno = " << errno << "\n";
+    }
+}
+
+void output_file_process_regex(char *fin, char *fout) {
     /**
      * This function is to check if the read access to the input file is OK
     */
@@ -48,12 +459,14 @@ void output_file_process(char *fin, char *fout) {
     else {
         char *file = read_file(fin);
         write_file(fout, file);
+        free(file);
     }
 }
 
 char *read_file(char *fin) {
     char read_buf[BUF_SIZE];
-    char *file;
+    char *file = NULL;
+    size_t total = 0;
     int size;
     int i = 1;
 	
@@ -68,17 +481,18 @@ char *read_file(char *fin) {
     */
     if (fdi > 0) {
         /*read a block of data*/
-        while ((size = read(fdi, read_buf, BUF_SIZE)) != 0) {
+        while ((size = read(fdi, read_buf, BUF_SIZE)) > 0) {
             if (i == 1) {
                 /*allocate memory and store the first block of data*/
-                file = (char *) malloc(sizeof(char) * BUF_SIZE);
-                file = strncpy(file, read_buf, size);
+                file = (char *) malloc(sizeof(char) * (BUF_SIZE + 1));
             }
             else {
                 /*reallocate memory and append the next block of data*/
-                file = (char *) realloc(file, sizeof(char) * BUF_SIZE * i);
-                strncpy(file + BUF_SIZE * (i - 1), read_buf, size);
+                file = (char *) realloc(file,
+                    sizeof(char) * (BUF_SIZE * i + 1));
             }
+            memcpy(file + total, read_buf, size);
+            total += size;
             i++;
         }
     }
@@ -91,6 +505,12 @@ char *read_file(char *fin) {
     if (fc < 0) {
         cout << "The file " << fin << " can not be closed\n";
     }
+
+    /*terminate the string, strtok in write_file relies on it*/
+    if (file == NULL) {
+        file = (char *) malloc(sizeof(char));
+    }
+    file[total] = '\0';
 	
     return(file);
 }
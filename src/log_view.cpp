@@ -0,0 +1,123 @@
+/** \brief This source file defines classes for reading simulator logs
+ * without copying them.
+ *
+ * The file is mapped with mmap and advised with MADV_SEQUENTIAL.
+ * Lines are found with memchr and handed out as std::string_view.
+*/
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/log_view.hpp"
+
+using namespace std;
+
+mapped_file::mapped_file() noexcept : _data(nullptr), _size(0) {
+}
+
+mapped_file::mapped_file(const char *path) noexcept
+    : _data(nullptr), _size(0) {
+    open(path);
+}
+
+mapped_file::mapped_file(mapped_file &&other) noexcept
+    : _data(other._data), _size(other._size) {
+    other._data = nullptr;
+    other._size = 0;
+}
+
+mapped_file &mapped_file::operator=(mapped_file &&other) noexcept {
+    if (this != &other) {
+        close();
+        _data = other._data;
+        _size = other._size;
+        other._data = nullptr;
+        other._size = 0;
+    }
+    return *this;
+}
+
+mapped_file::~mapped_file() {
+    close();
+}
+
+bool mapped_file::open(const char *path) noexcept {
+    struct stat st;
+
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    /**
+     * only regular files with some content can be mapped
+    */
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            _data = static_cast<const char *>(addr);
+            _size = st.st_size;
+        }
+    }
+    /**
+     * the mapping stays valid after the descriptor is closed
+    */
+    ::close(fd);
+    return is_open();
+}
+
+void mapped_file::close() noexcept {
+    if (_data != nullptr) {
+        munmap(const_cast<char *>(_data), _size);
+        _data = nullptr;
+        _size = 0;
+    }
+}
+
+void mapped_file::release(size_t offset) const noexcept {
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t length = offset < _size ? offset : _size;
+    length -= length % page;
+    if (_data != nullptr && length > 0) {
+        madvise(const_cast<char *>(_data), length, MADV_DONTNEED);
+    }
+}
+
+log_view::iterator::iterator(const char *begin, const char *end) noexcept
+    : _end(end) {
+    find_line(begin);
+}
+
+log_view::iterator &log_view::iterator::operator++() noexcept {
+    find_line(_line.data() + _line.size());
+    return *this;
+}
+
+void log_view::iterator::find_line(const char *from) noexcept {
+    /**
+     * skip the line terminators, strtok does not return empty lines
+    */
+    while (from != _end && (*from == '\n' || *from == '\r')) {
+        from++;
+    }
+    if (from == _end) {
+        _line = string_view(_end, 0);
+        return;
+    }
+    /**
+     * the line ends at the first "\n" or at an earlier "\r"
+    */
+    const char *nl = static_cast<const char *>(memchr(from, '\n', _end - from));
+    if (nl == nullptr) {
+        nl = _end;
+    }
+    const char *cr = static_cast<const char *>(memchr(from, '\r', nl - from));
+    if (cr != nullptr) {
+        nl = cr;
+    }
+    _line = string_view(from, nl - from);
+}
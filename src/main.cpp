@@ -14,6 +14,10 @@
 * |        |<-- Subnet2<--|         |<-- Subnet4<--|         |
 * |        |              |         |              |         |
 * ----------              -----------              -----------
+*
+* The model is built by abp_topology, which can also build many
+* channels like this one side by side, each with any number of
+* Repeaters, from a topology such as "channels=100 hops=3".
 */
 /* Peter Bliznyuk-Kvitko
 * Shubham Agrawal
@@ -37,38 +41,34 @@
 
 
 #include "../lib/DESTimes/include/NDTime.hpp"
+#include "../include/tick_time.hpp"
 #include "../lib/iestream.hpp"
 
 #include "../include/message.hpp"
 #include "../include/file_process.hpp"
+#include "../include/trace_logger.hpp"
+#include "../include/async_writer.hpp"
+#include "../include/filter_logger.hpp"
 
-#include "../include/sender_cadmium.hpp"
-#include "../include/receiver_cadmium.hpp"
-#include "../include/subnet_cadmium.hpp"
-#include "../include/repeater_cadmium.hpp"
+#include "../include/abp_topology.hpp"
+#include "../include/heap_runner.hpp"
+#include "../include/parallel_runner.hpp"
+#include "../include/timewarp_runner.hpp"
+#include "../include/traffic_generator_cadmium.hpp"
 
 #define ABP_OUTPUTFILE_PATH "../data/output/abp_output.txt"
 #define ABP_MODIFIED_PATH "../data/output/abp_proc.txt"
+#define ABP_TRACE_PATH "../data/output/abp_trace.bin"
+#define ABP_PARALLEL_WINDOW "00:01:00:000"
 
 using namespace std;
 
 using hclock=chrono::high_resolution_clock;
+#ifdef ABP_TICK_TIME
+using TIME = TickTime;
+#else
 using TIME = NDTime;
-
-
-/***** SETING INPUT PORTS FOR COUPLEDs *****/
-struct inp_control : public cadmium::in_port<Message_t>{};
-struct inp_1 : public cadmium::in_port<Message_t>{};
-struct inp_2 : public cadmium::in_port<Message_t>{};
-struct inp_3 : public cadmium::in_port<Message_t>{};
-struct inp_4 : public cadmium::in_port<Message_t>{};
-/***** SETING OUTPUT PORTS FOR COUPLEDs *****/
-struct outp_ack : public cadmium::out_port<Message_t>{};
-struct outp_1 : public cadmium::out_port<Message_t>{};
-struct outp_2 : public cadmium::out_port<Message_t>{};
-struct outp_3 : public cadmium::out_port<Message_t>{};
-struct outp_4 : public cadmium::out_port<Message_t>{};
-struct outp_pack : public cadmium::out_port<Message_t>{};
+#endif
 
 
 /********************************************/
@@ -85,21 +85,73 @@ public:
 
 int main(int argc, char ** argv) {
 
-    if (argc < 2) {
+    if (argc < 2 || (string(argv[1]) == "--traffic" && argc < 3)) {
         cout << "you are using this program with wrong parameters."
             << "The program should be invoked as follows:";
-        cout << argv[0] << " path to the input file " << endl;
+        cout << argv[0] << " path to the input file [\"topology\"]" << endl;
+        cout << "or: " << argv[0] << " --traffic \"traffic spec\" [\"topology\"]"
+            << endl;
         return 1; 
     }
 
+    /**
+     * With --traffic the control messages come from a synthetic
+     * workload of many sessions instead of the input file
+    */
+    bool traffic = string(argv[1]) == "--traffic";
+    traffic_spec spec;
+    string spec_error;
+    if (traffic && !spec.parse(argv[2], spec_error)) {
+        cout << "The traffic spec can not be used: " << spec_error << "\n";
+        return 1;
+    }
+
+    /**
+     * The topology, as "channels=100 hops=3", follows the input
+    */
+    abp_topology_config topology_config;
+    int topology_arg = traffic ? 3 : 2;
+    if (argc > topology_arg &&
+        !topology_config.parse(argv[topology_arg], spec_error)) {
+        cout << "The topology can not be used: " << spec_error << "\n";
+        return 1;
+    }
+
     auto start = hclock::now(); //to measure simulation execution time
 
     cout << " Program start\n";
-    char out_file[] = ABP_OUTPUTFILE_PATH;
     char proc_file[] = ABP_MODIFIED_PATH;
 
 /*************** Loggers *******************/
-    static std::ofstream out_data(out_file);
+#ifdef ABP_BINARY_TRACE
+    /**
+     * Output messages are written as binary records to the trace file,
+     * empty message bags are dropped. The trace is converted to the
+     * *_proc.txt table after the simulation, TRACE_CONVERT converts
+     * it to the text log.
+    */
+    char trace_file[] = ABP_TRACE_PATH;
+    static trace_writer out_trace(trace_file);
+    struct trace_sink_provider{
+        static trace_writer& sink(){
+            return out_trace;
+        }
+    };
+
+    using trace_messages=trace_logger<cadmium::logger::logger_messages,
+        cadmium::dynamic::logger::formatter<TIME>, trace_sink_provider>;
+    using trace_time=trace_logger<cadmium::logger::logger_global_time,
+        cadmium::dynamic::logger::formatter<TIME>, trace_sink_provider>;
+
+    using logger_top=cadmium::logger::multilogger<trace_messages, trace_time>;
+#else
+    char out_file[] = ABP_OUTPUTFILE_PATH;
+    /**
+     * The log is written to the file by an I/O thread, so the
+     * simulation does not wait on the file system. The log is
+     * complete once out_data is closed after the simulation.
+    */
+    static async_ofstream out_data(out_file, backpressure::block);
     struct oss_sink_provider{
         static std::ostream& sink(){          
             return out_data;
@@ -123,7 +175,12 @@ int main(int argc, char ** argv) {
     using log_all=cadmium::logger::multilogger<info, debug, state, log_messages,
         routing, global_time, local_time>;
 
-    using logger_top=cadmium::logger::multilogger<log_messages, global_time>;
+    using log_nonempty_messages=nonempty_logger<cadmium::logger::logger_messages,
+        cadmium::dynamic::logger::formatter<TIME>, oss_sink_provider>;
+
+    using logger_top=cadmium::logger::multilogger<log_nonempty_messages,
+        global_time>;
+#endif
 
 
 /*******************************************/
@@ -133,169 +190,73 @@ int main(int argc, char ** argv) {
 /********************************************/
 /****** APPLICATION GENERATOR ***************/
 /********************************************/
+    /**
+     * An input file is replayed by one generator connected to every
+     * Sender, a traffic spec gives every channel its own generator
+     * with its own seed
+    */
     string input_data_control = argv[1];
     const char * i_input_data_control = input_data_control.c_str();
 
-    std::shared_ptr<cadmium::dynamic::modeling::model> generator_con = 
-        cadmium::dynamic::translate::make_dynamic_atomic_model<ApplicationGen,
-            TIME, const char* >("generator_con" , std::move(i_input_data_control));
-
-
-/*********************************/
-/****** SENDER *******************/
-/*********************************/
-
-    std::shared_ptr<cadmium::dynamic::modeling::model> sender1 =
-        cadmium::dynamic::translate::make_dynamic_atomic_model<Sender, TIME>("sender1");
-
-/***********************************/
-/****** RECIEVER *******************/
-/***********************************/
-
-    std::shared_ptr<cadmium::dynamic::modeling::model> receiver1 =
-        cadmium::dynamic::translate::make_dynamic_atomic_model<Receiver, TIME>("receiver1");
-
-/***********************************/
-/****** REPEATER *******************/
-/***********************************/
-
-    std::shared_ptr<cadmium::dynamic::modeling::model> repeater1 =
-        cadmium::dynamic::translate::make_dynamic_atomic_model<Repeater, TIME>("repeater1");
-
-
-/*********************************/
-/****** SUBNET *******************/
-/*********************************/
-
-    std::shared_ptr<cadmium::dynamic::modeling::model> subnet1 =
-        cadmium::dynamic::translate::make_dynamic_atomic_model<Subnet, TIME>("subnet1");
-    std::shared_ptr<cadmium::dynamic::modeling::model> subnet2 =
-        cadmium::dynamic::translate::make_dynamic_atomic_model<Subnet, TIME>("subnet2");
-    std::shared_ptr<cadmium::dynamic::modeling::model> subnet3 =
-        cadmium::dynamic::translate::make_dynamic_atomic_model<Subnet, TIME>("subnet3");
-    std::shared_ptr<cadmium::dynamic::modeling::model> subnet4 =
-        cadmium::dynamic::translate::make_dynamic_atomic_model<Subnet, TIME>("subnet4");
-
-    cout << " Networks\n";
-
-
-/************************/
-/*******NETWORK ********/
-/************************/
-    cadmium::dynamic::modeling::Ports iports_Network =
-        {typeid(inp_1),typeid(inp_2)};
-    cadmium::dynamic::modeling::Ports oports_Network =
-        {typeid(outp_1),typeid(outp_2)};
-    cadmium::dynamic::modeling::Models submodels_Network =
-        {subnet1, subnet2, repeater1, subnet3, subnet4};
-    cadmium::dynamic::modeling::EICs eics_Network = {
-        cadmium::dynamic::translate::make_EIC<inp_1,
-            subnet_defs::in>("subnet1"),
-        cadmium::dynamic::translate::make_EIC<inp_2,
-            subnet_defs::in>("subnet4")
-    };
-    cadmium::dynamic::modeling::EOCs eocs_Network = {
-        cadmium::dynamic::translate::make_EOC
-            <subnet_defs::out,outp_1>("subnet2"),
-        cadmium::dynamic::translate::make_EOC
-            <subnet_defs::out,outp_2>("subnet3")
-    };
-    cadmium::dynamic::modeling::ICs ics_Network = {
-        cadmium::dynamic::translate::make_IC<repeater_defs::ack_received_out,
-            subnet_defs::in>("repeater1","subnet2"),
-        cadmium::dynamic::translate::make_IC<subnet_defs::out,
-            repeater_defs::packet_in>("subnet1","repeater1"),
-  
-        cadmium::dynamic::translate::make_IC<repeater_defs::packet_sent_out,
-            subnet_defs::in>("repeater1","subnet3"),
-        cadmium::dynamic::translate::make_IC<subnet_defs::out,
-            repeater_defs::ack_in>("subnet4","repeater1")
-    };
-    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> NETWORK =
-        std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(
-        "Network", 
-        submodels_Network, 
-        iports_Network, 
-        oports_Network, 
-        eics_Network, 
-        eocs_Network, 
-        ics_Network 
-    );
-
-    cout << " ABPSimulator\n";
-
-
-/************************/
-/*******ABPSimulator********/
-/************************/
-    cadmium::dynamic::modeling::Ports iports_ABPSimulator =
-        {typeid(inp_control)};
-    cadmium::dynamic::modeling::Ports oports_ABPSimulator =
-        {typeid(outp_ack),typeid(outp_pack)};
-    cadmium::dynamic::modeling::Models submodels_ABPSimulator =
-        {sender1, receiver1,NETWORK};
-    cadmium::dynamic::modeling::EICs eics_ABPSimulator = {
-        cadmium::dynamic::translate::make_EIC<inp_control,
-            sender_defs::control_in>("sender1")
-    };
-    cadmium::dynamic::modeling::EOCs eocs_ABPSimulator = {
-        cadmium::dynamic::translate::make_EOC
-            <sender_defs::packet_sent_out,outp_pack>("sender1"),
-        cadmium::dynamic::translate::make_EOC
-            <sender_defs::ack_received_out,outp_ack>("sender1")
+    auto make_file_generator = [&](const string &name, unsigned) {
+        return cadmium::dynamic::translate::make_dynamic_atomic_model<ApplicationGen,
+            TIME, const char* >(name , std::move(i_input_data_control));
     };
-    cadmium::dynamic::modeling::ICs ics_ABPSimulator = {
-        cadmium::dynamic::translate::make_IC
-            <sender_defs::data_out, inp_1>("sender1","Network"),
-        cadmium::dynamic::translate::make_IC
-            <outp_1, sender_defs::ack_in>("Network","sender1"),
-        cadmium::dynamic::translate::make_IC
-            <receiver_defs::out, inp_2>("receiver1","Network"),
-        cadmium::dynamic::translate::make_IC
-            <outp_2, receiver_defs::in>("Network","receiver1")
+    auto make_traffic_generator = [&](const string &name, unsigned channel) {
+        traffic_spec channel_spec = spec;
+        channel_spec.seed = spec.seed + channel - 1;
+        return cadmium::dynamic::translate::make_dynamic_atomic_model<TrafficGenerator,
+            TIME, traffic_spec>(name, std::move(channel_spec));
     };
-    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> ABPSimulator =
-        std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(
-        "ABPSimulator", 
-        submodels_ABPSimulator, 
-        iports_ABPSimulator, 
-        oports_ABPSimulator, 
-        eics_ABPSimulator, 
-        eocs_ABPSimulator, 
-        ics_ABPSimulator 
-    );
 
     cout << " TOP Model\n";
 
 /************************/
 /*******TOP MODEL********/
 /************************/
-    cadmium::dynamic::modeling::Ports iports_TOP = {};
-    cadmium::dynamic::modeling::Ports oports_TOP =
-        {typeid(outp_pack),typeid(outp_ack)};
-    cadmium::dynamic::modeling::Models submodels_TOP =
-        {generator_con, ABPSimulator};
-    cadmium::dynamic::modeling::EICs eics_TOP = {};
-    cadmium::dynamic::modeling::EOCs eocs_TOP = {
-        cadmium::dynamic::translate::make_EOC
-            <outp_pack,outp_pack>("ABPSimulator"),
-        cadmium::dynamic::translate::make_EOC
-            <outp_pack,outp_ack>("ABPSimulator")
-    };
-    cadmium::dynamic::modeling::ICs ics_TOP = {
-        cadmium::dynamic::translate::make_IC
-            <iestream_input_defs<Message_t>::out,inp_control>("generator_con","ABPSimulator")
+    /**
+     * With scheduler=heap the flattened models are added to the
+     * heap runner instead, with scheduler=parallel to the parallel
+     * runner and with scheduler=timewarp to the Time Warp runner
+    */
+    abp_topology<TIME> topology(topology_config);
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> TOP;
+    heap_runner<TIME, logger_top> heap;
+    parallel_runner<TIME, logger_top> parallel(topology_config.threads,
+        TIME(ABP_PARALLEL_WINDOW));
+    timewarp_runner<TIME, logger_top> timewarp(topology_config.threads,
+        TIME(ABP_PARALLEL_WINDOW));
+    auto build_flat = [&](auto &runner) {
+        if (traffic) {
+            topology.build_flat<traffic_generator_defs::out>(runner,
+                [&](const string &name, unsigned channel) {
+                    traffic_spec channel_spec = spec;
+                    channel_spec.seed = spec.seed + channel - 1;
+                    runner.template add<TrafficGenerator>(name, channel_spec);
+                }, true);
+        }
+        else {
+            topology.build_flat<iestream_input_defs<Message_t>::out>(runner,
+                [&](const string &name, unsigned) {
+                    runner.template add<ApplicationGen>(name,
+                                                        i_input_data_control);
+                }, false);
+        }
     };
-    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> TOP =
-        std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(
-        "TOP", 
-        submodels_TOP, 
-        iports_TOP, 
-        oports_TOP, 
-        eics_TOP, 
-        eocs_TOP, 
-        ics_TOP 
-    );
+    if (!topology_config.heap_scheduler) {
+        TOP = traffic ?
+            topology.build<traffic_generator_defs::out>(make_traffic_generator, true) :
+            topology.build<iestream_input_defs<Message_t>::out>(make_file_generator, false);
+    }
+    else if (topology_config.parallel_scheduler) {
+        build_flat(parallel);
+    }
+    else if (topology_config.timewarp_scheduler) {
+        build_flat(timewarp);
+    }
+    else {
+        build_flat(heap);
+    }
 
 ///****************////
 
@@ -303,17 +264,57 @@ int main(int argc, char ** argv) {
         std::ratio<1>>>(hclock::now() - start).count();
     cout << "Model Created. Elapsed time: " << elapsed1 << "sec" << endl;
     
-    cadmium::dynamic::engine::runner<NDTime, logger_top> r(TOP, {0});
+    std::unique_ptr<cadmium::dynamic::engine::runner<TIME, logger_top>> r;
+    if (topology_config.parallel_scheduler) {
+        parallel.start(TIME{0});
+        cout << "Partitions: " << parallel.partitions() << endl;
+    }
+    else if (topology_config.timewarp_scheduler) {
+        timewarp.start(TIME{0});
+        cout << "Processes: " << timewarp.processes() << endl;
+    }
+    else if (topology_config.heap_scheduler) {
+        heap.start(TIME{0});
+    }
+    else {
+        r.reset(new cadmium::dynamic::engine::runner<TIME, logger_top>(TOP,
+            TIME{0}));
+    }
     elapsed1 = std::chrono::duration_cast<std::chrono::duration<double,
         std::ratio<1>>>(hclock::now() - start).count();
     cout << "Runner Created. Elapsed time: " << elapsed1 << "sec" << endl;
 
     cout << "Simulation starts" << endl;
 
-    r.run_until(NDTime("04:00:00:000"));
+    if (topology_config.parallel_scheduler) {
+        parallel.run_until(TIME("04:00:00:000"));
+    }
+    else if (topology_config.timewarp_scheduler) {
+        timewarp.run_until(TIME("04:00:00:000"));
+        cout << "Rolled back steps: " << timewarp.rolled_back() << " of "
+             << timewarp.steps() << ", anti-messages: "
+             << timewarp.anti_messages() << endl;
+    }
+    else if (topology_config.heap_scheduler) {
+        heap.run_until(TIME("04:00:00:000"));
+    }
+    else {
+        r->run_until(TIME("04:00:00:000"));
+    }
     auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
         std::ratio<1>>>(hclock::now() - start).count();
     cout << "Simulation took:" << elapsed << "sec" << endl;
-    output_file_process(out_file, proc_file);
+#ifdef ABP_BINARY_TRACE
+    out_trace.close();
+    trace_to_proc(trace_file, proc_file);
+#else
+    out_data.close();
+    cout << "Empty message bags not logged: "
+         << log_nonempty_messages::suppressed() << endl;
+    if (out_data.dropped_lines() > 0) {
+        cout << "Log lines dropped: " << out_data.dropped_lines() << endl;
+    }
+    output_file_process(out_file, proc_file, 0);
+#endif
     return 0;
 }
@@ -0,0 +1,126 @@
+/** \brief This file contains main function for the static ABP simulator
+*
+* It simulates the same model as ABP with its default topology,
+*
+* ----------              -----------              -----------
+* |        |              |         |              |         |
+* | Sender1|--> Subnet1-->|Repeater1|--> Subnet3-->|Receiver1|
+* |        |<-- Subnet2<--|         |<-- Subnet4<--|         |
+* |        |              |         |              |         |
+* ----------              -----------              -----------
+*
+* with the static PDEVS runner of Cadmium. The hierarchy of coupled
+* models is declared in abp_static.hpp and fixed at compile time,
+* so the topology can not be given on the command line.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <string>
+
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/coupled_model.hpp>
+#include <cadmium/engine/pdevs_runner.hpp>
+#include <cadmium/logger/tuple_to_ostream.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+
+#include "../lib/DESTimes/include/NDTime.hpp"
+#include "../include/tick_time.hpp"
+#include "../lib/iestream.hpp"
+
+#include "../include/message.hpp"
+#include "../include/file_process.hpp"
+#include "../include/async_writer.hpp"
+#include "../include/filter_logger.hpp"
+
+#include "../include/abp_static.hpp"
+
+#define ABP_OUTPUTFILE_PATH "../data/output/abp_output.txt"
+#define ABP_MODIFIED_PATH "../data/output/abp_proc.txt"
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+#ifdef ABP_TICK_TIME
+using TIME = TickTime;
+#else
+using TIME = NDTime;
+#endif
+
+
+/********************************************/
+/****** APPLICATION GENERATOR ***************/
+/********************************************/
+/**
+ * The static runner constructs the models itself,
+ * so the generator reads the input file set in main
+*/
+static const char *input_file_path = nullptr;
+
+template<typename T>
+class generator_con : public iestream_input<Message_t,T> {
+public:
+    generator_con() :
+        iestream_input<Message_t,T>(input_file_path) {}
+};
+
+using TOP = abp_static_top<generator_con,
+    iestream_input_defs<Message_t>::out>;
+
+
+int main(int argc, char ** argv) {
+
+    if (argc < 2) {
+        cout << "you are using this program with wrong parameters."
+            << "The program should be invoked as follows:";
+        cout << argv[0] << " path to the input file" << endl;
+        return 1;
+    }
+    input_file_path = argv[1];
+
+    auto start = hclock::now(); //to measure simulation execution time
+
+    cout << " Program start\n";
+    char out_file[] = ABP_OUTPUTFILE_PATH;
+    char proc_file[] = ABP_MODIFIED_PATH;
+
+/*************** Loggers *******************/
+    static async_ofstream out_data(out_file, backpressure::block);
+    struct oss_sink_provider{
+        static std::ostream& sink(){
+            return out_data;
+        }
+    };
+
+    using global_time=cadmium::logger::logger<cadmium::logger::logger_global_time,
+        cadmium::logger::formatter<TIME>, oss_sink_provider>;
+    using log_nonempty_messages=nonempty_logger<cadmium::logger::logger_messages,
+        cadmium::logger::formatter<TIME>, oss_sink_provider>;
+
+    using logger_top=cadmium::logger::multilogger<log_nonempty_messages,
+        global_time>;
+
+/*******************************************/
+
+    cadmium::engine::runner<TIME, TOP::type, logger_top> r(TIME{0});
+    auto elapsed1 = std::chrono::duration_cast<std::chrono::duration<double,
+        std::ratio<1>>>(hclock::now() - start).count();
+    cout << "Runner Created. Elapsed time: " << elapsed1 << "sec" << endl;
+
+    cout << "Simulation starts" << endl;
+
+    r.runUntil(TIME("04:00:00:000"));
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
+        std::ratio<1>>>(hclock::now() - start).count();
+    cout << "Simulation took:" << elapsed << "sec" << endl;
+    out_data.close();
+    cout << "Empty message bags not logged: "
+         << log_nonempty_messages::suppressed() << endl;
+    if (out_data.dropped_lines() > 0) {
+        cout << "Log lines dropped: " << out_data.dropped_lines() << endl;
+    }
+    output_file_process(out_file, proc_file, 0);
+    return 0;
+}
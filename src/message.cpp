@@ -11,7 +11,7 @@
 /***************************************************/
 
 ostream& operator<<(ostream& os, const Message_t& msg) {
-  os << msg.value;
+  os << msg.legacy_value();
   return os;
 }
 
@@ -19,7 +19,19 @@ ostream& operator<<(ostream& os, const Message_t& msg) {
 /************* Input stream ************************/
 /***************************************************/
 
+/**
+ * Negative values of the old float inputs are read as 0, a control
+ * of no packets, which leaves the Sender passive as they did.
+*/
 istream& operator>> (istream& is, Message_t& msg) {
-  is >> msg.value;
+  int64_t value;
+  if (is >> value) {
+    if (value > UINT32_MAX) {
+      is.setstate(ios::failbit);
+    }
+    else {
+      msg = Message_t(value < 0 ? 0 : (uint32_t) value);
+    }
+  }
   return is;
 }
@@ -0,0 +1,167 @@
+/** \brief This source file implements the parameter sweep.
+ *
+ * The points of a Latin hypercube are drawn from the counter_rng
+ * stream "lhs" of the seed, so a design is reproduced by its seed.
+*/
+
+#include <stdio.h>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "../include/counter_rng.hpp"
+#include "../include/parameter_sweep.hpp"
+
+using namespace std;
+
+/**
+ * Function that checks that a key is a model constant.
+*/
+static bool is_sweep_key(const string &key) {
+    abp_topology_config config;
+    return key == "delivery" || key == "bandwidth" || key == "service_rate" ||
+           config.time_parameter(key) != nullptr;
+}
+
+bool sweep_design::parse(const char *text, uint64_t seed, string &error) {
+    istringstream in(text);
+    string kind;
+    unsigned samples = 0;
+    in >> kind;
+    if (kind.compare(0, 4, "lhs=") == 0) {
+        istringstream value(kind.substr(4));
+        if (!(value >> samples) || !value.eof() || samples == 0) {
+            error = "wrong number of samples " + kind;
+            return false;
+        }
+    }
+    else if (kind != "grid") {
+        error = "the design must start with grid or lhs=N";
+        return false;
+    }
+
+    _parameters.clear();
+    string item;
+    while (in >> item) {
+        sweep_parameter parameter;
+        size_t eq = item.find('=');
+        parameter.key = item.substr(0, eq);
+        string range = eq == string::npos ? "" : item.substr(eq + 1);
+        for (char &c : range) {
+            if (c == ':') {
+                c = ' ';
+            }
+        }
+        istringstream value(range);
+        bool ok = is_sweep_key(parameter.key) &&
+                  (value >> parameter.min >> parameter.max) &&
+                  parameter.min <= parameter.max;
+        if (ok && samples == 0) {
+            ok = (value >> parameter.steps) && parameter.steps > 0;
+        }
+        if (!ok || !(value >> ws).eof()) {
+            error = "wrong sweep parameter " + item;
+            return false;
+        }
+        _parameters.push_back(parameter);
+    }
+
+    _points.clear();
+    if (samples == 0) {
+        /**
+         * the first key changes slowest
+        */
+        size_t points = 1;
+        for (const auto &parameter : _parameters) {
+            points *= parameter.steps;
+        }
+        _points.resize(points);
+        for (size_t p = 0; p < points; p++) {
+            size_t rest = p;
+            _points[p].resize(_parameters.size());
+            for (size_t k = _parameters.size(); k-- > 0;) {
+                const sweep_parameter &parameter = _parameters[k];
+                unsigned step = rest % parameter.steps;
+                rest /= parameter.steps;
+                _points[p][k] = parameter.steps == 1 ? parameter.min :
+                    parameter.min + (parameter.max - parameter.min) *
+                        step / (parameter.steps - 1);
+            }
+        }
+    }
+    else {
+        counter_rng rng(seed, "lhs");
+        _points.assign(samples, vector<double>(_parameters.size()));
+        vector<unsigned> strata(samples);
+        for (size_t k = 0; k < _parameters.size(); k++) {
+            const sweep_parameter &parameter = _parameters[k];
+            for (unsigned s = 0; s < samples; s++) {
+                strata[s] = s;
+            }
+            for (unsigned s = samples - 1; s > 0; s--) {
+                swap(strata[s], strata[rng() % (s + 1)]);
+            }
+            for (unsigned p = 0; p < samples; p++) {
+                _points[p][k] = parameter.min +
+                    (parameter.max - parameter.min) *
+                        (strata[p] + rng.uniform()) / samples;
+            }
+        }
+    }
+    return true;
+}
+
+bool sweep_design::apply(size_t p, abp_topology_config &config,
+                         string &error) const {
+    string text;
+    char value[32];
+    for (size_t k = 0; k < _parameters.size(); k++) {
+        snprintf(value, sizeof(value), "%.17g", _points[p][k]);
+        text += _parameters[k].key + "=" + value + " ";
+    }
+    return config.parse(text.c_str(), error);
+}
+
+work_stealing_pool::work_stealing_pool(unsigned workers) :
+    _queues(workers > 0 ? workers : 1) {
+}
+
+void work_stealing_pool::run(size_t n, const function<void(size_t)> &task) {
+    for (size_t t = 0; t < n; t++) {
+        _queues[t % _queues.size()].tasks.push_back(t);
+    }
+    vector<thread> threads;
+    for (unsigned w = 0; w < _queues.size(); w++) {
+        threads.emplace_back([this, w, &task]() {
+            size_t t;
+            while (next_task(w, t)) {
+                task(t);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+
+bool work_stealing_pool::next_task(unsigned worker, size_t &task) {
+    {
+        queue_type &own = _queues[worker];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (unsigned i = 1; i < _queues.size(); i++) {
+        queue_type &victim = _queues[(worker + i) % _queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,215 @@
+/** \brief This source file defines the metrics of a replication.
+ *
+ * Only the messages of models named sender* are read. A packet of
+ * a session sent again before it is acknowledged is a retransmission.
+ * An acknowledgement holding the number of an outstanding packet
+ * delivers that packet, as the WindowSender outputs; otherwise it is
+ * the alternating bit of a Sender, whose only outstanding packet is
+ * delivered. Lines logged as text have no session, all their packets
+ * are of session 0.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "../include/replication_metrics.hpp"
+
+using namespace std;
+
+/**
+ * separator between the port list and the name of model
+*/
+static const string_view MODEL_SEPARATOR = "] generated by model ";
+
+/**
+ * Function that returns the values of a port of a message line,
+ * or an empty view if the port is not in the line.
+*/
+static string_view port_values(string_view body, string_view port) {
+    size_t p = body.find(port);
+    if (p == string_view::npos) {
+        return string_view();
+    }
+    size_t start = p + port.size();
+    size_t end = body.find('}', start);
+    return body.substr(start, end == string_view::npos ? 0 : end - start);
+}
+
+/**
+ * Function that reads the comma separated values of a port.
+*/
+static vector<int> message_values(string_view values) {
+    vector<int> result;
+    string text(values);
+    const char *p = text.c_str();
+    char *end;
+    while (*p) {
+        long v = strtol(p, &end, 10);
+        if (end == p) {
+            p++;
+            continue;
+        }
+        result.push_back((int) v);
+        p = end;
+    }
+    return result;
+}
+
+/**
+ * Function that returns the key of a packet of a session.
+*/
+static uint64_t packet_key(uint16_t session, uint32_t packet) {
+    return (uint64_t) session << 32 | packet;
+}
+
+metrics_collector &metrics_collector::current() {
+    static thread_local metrics_collector collector;
+    return collector;
+}
+
+void metrics_collector::reset() {
+    _ticks = 0;
+    _metrics = replication_metrics();
+    _senders.clear();
+}
+
+void metrics_collector::time(int64_t ticks) {
+    _ticks = ticks;
+}
+
+void metrics_collector::messages(string_view model,
+                                 const message_bag_text &bag) {
+    if (bag.messages->empty() || model.substr(0, 6) != "sender") {
+        return;
+    }
+    const sender_ports &ports = ports_of(*bag.ports);
+    sender_type *sender = nullptr;
+    for (const auto &m : *bag.messages) {
+        if (m.first != ports.sent && m.first != ports.acked) {
+            continue;
+        }
+        if (sender == nullptr) {
+            sender = &_senders[string(model)];
+        }
+        uint64_t packet = packet_key(m.second.session, m.second.seq);
+        if (m.first == ports.sent) {
+            sent(*sender, packet);
+        }
+        else {
+            acknowledged(*sender, packet,
+                         m.second.type() == message_kind::ack);
+        }
+    }
+}
+
+void metrics_collector::message_line(string_view line) {
+    size_t q = line.rfind(MODEL_SEPARATOR);
+    if (q == string_view::npos) {
+        return;
+    }
+    string_view model = line.substr(q + MODEL_SEPARATOR.size());
+    if (model.substr(0, 6) != "sender") {
+        return;
+    }
+    string_view body = line.substr(0, q);
+    string_view sent_values = port_values(body, "packet_sent_out: {");
+    string_view acked_values = port_values(body, "ack_received_out: {");
+    if (sent_values.empty() && acked_values.empty()) {
+        return;
+    }
+
+    sender_type &sender = _senders[string(model)];
+    for (int packet : message_values(sent_values)) {
+        sent(sender, packet_key(0, (uint32_t) packet));
+    }
+    for (int ack : message_values(acked_values)) {
+        acknowledged(sender, packet_key(0, (uint32_t) ack), false);
+    }
+}
+
+void metrics_collector::sent(sender_type &sender, uint64_t packet) {
+    _metrics.transmissions++;
+    if (sender.outstanding.count(packet)) {
+        _metrics.retransmissions++;
+    }
+    else {
+        sender.outstanding[packet] = _ticks;
+    }
+}
+
+void metrics_collector::acknowledged(sender_type &sender, uint64_t packet,
+                                     bool alternating_bit) {
+    auto p = alternating_bit ? sender.outstanding.end() :
+        sender.outstanding.find(packet);
+    if (p == sender.outstanding.end()) {
+        if (sender.outstanding.size() != 1) {
+            return;
+        }
+        p = sender.outstanding.begin();
+    }
+    _metrics.delivered++;
+    _metrics.latency_sum += (_ticks - p->second) / 1000.0;
+    sender.outstanding.erase(p);
+}
+
+const metrics_collector::sender_ports &metrics_collector::ports_of(
+    const vector<string> &names) {
+    auto p = _ports.find(&names);
+    if (p != _ports.end()) {
+        return p->second;
+    }
+    sender_ports ports = {-1, -1};
+    for (size_t i = 0; i < names.size(); i++) {
+        string_view name = names[i];
+        if (name.size() >= 15 &&
+            name.substr(name.size() - 15) == "packet_sent_out") {
+            ports.sent = (int) i;
+        }
+        else if (name.size() >= 16 &&
+                 name.substr(name.size() - 16) == "ack_received_out") {
+            ports.acked = (int) i;
+        }
+    }
+    return _ports[&names] = ports;
+}
+
+replication_metrics metrics_collector::finish(double seconds) const {
+    replication_metrics metrics = _metrics;
+    metrics.seconds = seconds;
+    return metrics;
+}
+
+metric_summary summarize(const vector<double> &values) {
+    /**
+     * two sided 95% quantiles of the Student t distribution
+     * for 1 to 30 degrees of freedom
+    */
+    static const double t_95[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+        2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+        2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+        2.048, 2.045, 2.042
+    };
+    metric_summary summary;
+    size_t n = values.size();
+    if (n == 0) {
+        return summary;
+    }
+    double sum = 0;
+    for (double v : values) {
+        sum += v;
+    }
+    summary.mean = sum / n;
+    if (n == 1) {
+        return summary;
+    }
+    double squares = 0;
+    for (double v : values) {
+        squares += (v - summary.mean) * (v - summary.mean);
+    }
+    summary.stddev = sqrt(squares / (n - 1));
+    double t = n - 1 <= 30 ? t_95[n - 2] : 1.96;
+    summary.half_width = t * summary.stddev / sqrt((double) n);
+    return summary;
+}
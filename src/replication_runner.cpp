@@ -0,0 +1,119 @@
+/** \brief This source file simulates one replication.
+ *
+ * The metrics loggers read the logged lines of the Senders and
+ * keep the counters of the thread; the runner keeps no other state,
+ * so replications run on many threads at once.
+*/
+
+#include <iostream>
+#include <string>
+
+#include <cadmium/modeling/dynamic_model_translator.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+#include "../lib/DESTimes/include/NDTime.hpp"
+#include "../lib/iestream.hpp"
+
+#include "../include/message.hpp"
+#include "../include/heap_runner.hpp"
+#include "../include/replication_runner.hpp"
+
+using namespace std;
+
+using TIME = NDTime;
+
+/********************************************/
+/****** APPLICATION GENERATOR ***************/
+/********************************************/
+template<typename T>
+class ApplicationGen : public iestream_input<Message_t,T> {
+public:
+    ApplicationGen() = default;
+    ApplicationGen(const char* file_path) :
+        iestream_input<Message_t,T>(file_path) {}
+};
+
+/**
+ * The metrics loggers write nothing, their sink is never used
+*/
+struct null_sink_provider{
+    static std::ostream& sink(){
+        return std::cout;
+    }
+};
+
+using metrics_messages=metrics_logger<cadmium::logger::logger_messages,
+    cadmium::dynamic::logger::formatter<TIME>, null_sink_provider>;
+using metrics_time=metrics_logger<cadmium::logger::logger_global_time,
+    cadmium::dynamic::logger::formatter<TIME>, null_sink_provider>;
+using logger_top=cadmium::logger::multilogger<metrics_messages, metrics_time>;
+
+/**
+ * Function that simulates one replication with the heap runner.
+ * The replications already run in threads of their own, so
+ * scheduler=parallel and scheduler=timewarp run them with the heap
+ * runner as well.
+*/
+static replication_metrics run_heap_replication(unsigned r,
+    const replication_input &input, const abp_topology_config &config) {
+    uint64_t channels = config.channels;
+    abp_topology<TIME> topology(config);
+    heap_runner<TIME, logger_top> runner;
+    if (input.traffic) {
+        topology.build_flat<traffic_generator_defs::out>(runner,
+            [&](const string &name, unsigned channel) {
+                traffic_spec channel_spec = input.spec;
+                channel_spec.seed = input.spec.seed +
+                    (uint64_t) r * channels + channel - 1;
+                runner.add<TrafficGenerator>(name, channel_spec);
+            }, true);
+    }
+    else {
+        topology.build_flat<iestream_input_defs<Message_t>::out>(runner,
+            [&](const string &name, unsigned) {
+                runner.add<ApplicationGen>(name,
+                                           (const char*) input.input_file);
+            }, false);
+    }
+
+    metrics_collector::current().reset();
+    runner.start(TIME{0});
+    runner.run_until(TIME(REPLICATION_RUN_UNTIL));
+    return metrics_collector::current().finish(REPLICATION_RUN_SECONDS);
+}
+
+replication_metrics run_replication(unsigned r, const replication_input &input,
+                                    abp_topology_config config) {
+    uint64_t channels = config.channels;
+    config.seed += r;
+    if (config.heap_scheduler) {
+        return run_heap_replication(r, input, config);
+    }
+    abp_topology<TIME> topology(config);
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> TOP;
+    if (input.traffic) {
+        TOP = topology.build<traffic_generator_defs::out>(
+            [&](const string &name, unsigned channel) {
+                traffic_spec channel_spec = input.spec;
+                channel_spec.seed = input.spec.seed +
+                    (uint64_t) r * channels + channel - 1;
+                return cadmium::dynamic::translate::make_dynamic_atomic_model
+                    <TrafficGenerator, TIME, traffic_spec>(name,
+                        std::move(channel_spec));
+            }, true);
+    }
+    else {
+        TOP = topology.build<iestream_input_defs<Message_t>::out>(
+            [&](const string &name, unsigned) {
+                return cadmium::dynamic::translate::make_dynamic_atomic_model
+                    <ApplicationGen, TIME, const char*>(name,
+                        (const char*) input.input_file);
+            }, false);
+    }
+
+    metrics_collector::current().reset();
+    cadmium::dynamic::engine::runner<TIME, logger_top> runner(TOP, {0});
+    runner.run_until(TIME(REPLICATION_RUN_UNTIL));
+    return metrics_collector::current().finish(REPLICATION_RUN_SECONDS);
+}
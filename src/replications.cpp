@@ -0,0 +1,104 @@
+/** \brief This file contains main function for the replication runner.
+ *
+ * The runner simulates R independent replications of the ABP model
+ * on all cores. Replication r uses the seed of the topology plus r
+ * for the Subnets and, with a traffic spec, for the generators.
+ * Every worker thread takes the next replication to run and
+ * simulates it with run_replication. The metrics of every
+ * replication are kept in memory and their mean is printed with
+ * its 95% confidence interval.
+ *
+ * Usage: ./ABP_REPLICATIONS R input_file ["topology"]
+ *    or: ./ABP_REPLICATIONS R --traffic "traffic spec" ["topology"]
+*/
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/abp_topology.hpp"
+#include "../include/traffic_generator_cadmium.hpp"
+#include "../include/replication_metrics.hpp"
+#include "../include/replication_runner.hpp"
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+
+int main(int argc, char ** argv) {
+
+    if (argc < 3 || (string(argv[2]) == "--traffic" && argc < 4)) {
+        cout << "you are using this program with wrong parameters."
+            << "The program should be invoked as follows:";
+        cout << argv[0] << " replications path to the input file"
+            << " [\"topology\"]" << endl;
+        cout << "or: " << argv[0] << " replications --traffic"
+            << " \"traffic spec\" [\"topology\"]" << endl;
+        return 1;
+    }
+
+    unsigned replications = atoi(argv[1]);
+    replication_input input;
+    input.traffic = string(argv[2]) == "--traffic";
+    input.input_file = argv[2];
+    abp_topology_config config;
+    string error;
+    if (input.traffic && !input.spec.parse(argv[3], error)) {
+        cout << "The traffic spec can not be used: " << error << "\n";
+        return 1;
+    }
+    int topology_arg = input.traffic ? 4 : 3;
+    if (argc > topology_arg && !config.parse(argv[topology_arg], error)) {
+        cout << "The topology can not be used: " << error << "\n";
+        return 1;
+    }
+
+    auto start = hclock::now();
+    vector<replication_metrics> metrics(replications);
+    atomic<unsigned> next(0);
+    unsigned workers = max(1u, min(thread::hardware_concurrency(),
+                                   replications));
+    vector<thread> threads;
+    for (unsigned w = 0; w < workers; w++) {
+        threads.emplace_back([&]() {
+            for (unsigned r = next++; r < replications; r = next++) {
+                metrics[r] = run_replication(r, input, config);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
+        std::ratio<1>>>(hclock::now() - start).count();
+
+    struct metric_type {
+        const char *name;
+        double (replication_metrics::*value)() const;
+    };
+    static const metric_type reported[] = {
+        {"throughput (packets/s)", &replication_metrics::throughput},
+        {"goodput (packets/s)", &replication_metrics::goodput},
+        {"retransmission rate", &replication_metrics::retransmission_rate},
+        {"ack latency (s)", &replication_metrics::ack_latency}
+    };
+    cout << replications << " replications on " << workers
+         << " threads took " << elapsed << "sec" << endl;
+    printf("%-24s %-14s %-14s %s\n", "Metric", "Mean", "Std dev",
+           "95% confidence interval");
+    vector<double> values(replications);
+    for (const auto &m : reported) {
+        for (unsigned r = 0; r < replications; r++) {
+            values[r] = (metrics[r].*m.value)();
+        }
+        metric_summary s = summarize(values);
+        printf("%-24s %-14.6g %-14.6g [%g, %g]\n", m.name, s.mean, s.stddev,
+               s.mean - s.half_width, s.mean + s.half_width);
+    }
+    return 0;
+}
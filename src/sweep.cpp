@@ -0,0 +1,123 @@
+/** \brief This file contains main function for the parameter sweep.
+ *
+ * The sweep simulates R replications of the ABP model at every
+ * point of a grid or Latin hypercube design over the constants of
+ * the models, such as the timeout of the Sender or the delivery
+ * probability of the Subnets. Replication r of every point uses the
+ * same seeds, so the points are compared on the same random streams.
+ * The runs are scheduled on a work stealing thread pool and every
+ * finished run is appended as a row to one CSV results file:
+ *
+ * point,replication,KEY...,transmissions,retransmissions,delivered,
+ * throughput,goodput,retransmission_rate,ack_latency
+ *
+ * Usage: ./ABP_SWEEP "design" R results_file input_file ["topology"]
+ *    or: ./ABP_SWEEP "design" R results_file --traffic "traffic spec"
+ *        ["topology"]
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+
+#include "../include/abp_topology.hpp"
+#include "../include/parameter_sweep.hpp"
+#include "../include/replication_metrics.hpp"
+#include "../include/replication_runner.hpp"
+
+using namespace std;
+
+using hclock=chrono::high_resolution_clock;
+
+int main(int argc, char ** argv) {
+
+    if (argc < 5 || (string(argv[4]) == "--traffic" && argc < 6)) {
+        cout << "you are using this program with wrong parameters."
+            << "The program should be invoked as follows:";
+        cout << argv[0] << " \"design\" replications path to the results"
+            << " file path to the input file [\"topology\"]" << endl;
+        cout << "or: " << argv[0] << " \"design\" replications path to the"
+            << " results file --traffic \"traffic spec\" [\"topology\"]"
+            << endl;
+        return 1;
+    }
+
+    unsigned replications = atoi(argv[2]);
+    replication_input input;
+    input.traffic = string(argv[4]) == "--traffic";
+    input.input_file = argv[4];
+    abp_topology_config config;
+    string error;
+    if (input.traffic && !input.spec.parse(argv[5], error)) {
+        cout << "The traffic spec can not be used: " << error << "\n";
+        return 1;
+    }
+    int topology_arg = input.traffic ? 6 : 5;
+    if (argc > topology_arg && !config.parse(argv[topology_arg], error)) {
+        cout << "The topology can not be used: " << error << "\n";
+        return 1;
+    }
+    sweep_design design;
+    if (!design.parse(argv[1], config.seed, error)) {
+        cout << "The design can not be used: " << error << "\n";
+        return 1;
+    }
+    vector<abp_topology_config> configs(design.points(), config);
+    for (size_t p = 0; p < design.points(); p++) {
+        if (!design.apply(p, configs[p], error)) {
+            cout << "The design point " << p << " can not be used: "
+                 << error << "\n";
+            return 1;
+        }
+    }
+
+    FILE *results = fopen(argv[3], "w");
+    if (results == NULL) {
+        cout << "The file " << argv[3]
+             << " can not be opened for writing, errno = " << errno << "\n";
+        return 1;
+    }
+    fprintf(results, "point,replication");
+    for (const auto &parameter : design.parameters()) {
+        fprintf(results, ",%s", parameter.key.c_str());
+    }
+    fprintf(results, ",transmissions,retransmissions,delivered,throughput,"
+            "goodput,retransmission_rate,ack_latency\n");
+
+    auto start = hclock::now();
+    mutex results_lock;
+    size_t runs = design.points() * replications;
+    work_stealing_pool pool(max(1u, min<unsigned>(thread::hardware_concurrency(),
+                                                   runs)));
+    pool.run(runs, [&](size_t run) {
+        size_t p = run / replications;
+        unsigned r = run % replications;
+        replication_metrics m = run_replication(r, input, configs[p]);
+
+        lock_guard<mutex> guard(results_lock);
+        fprintf(results, "%zu,%u", p, r);
+        for (double value : design.point(p)) {
+            fprintf(results, ",%.17g", value);
+        }
+        fprintf(results, ",%llu,%llu,%llu,%.17g,%.17g,%.17g,%.17g\n",
+                (unsigned long long) m.transmissions,
+                (unsigned long long) m.retransmissions,
+                (unsigned long long) m.delivered, m.throughput(),
+                m.goodput(), m.retransmission_rate(), m.ack_latency());
+        fflush(results);
+    });
+    fclose(results);
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double,
+        std::ratio<1>>>(hclock::now() - start).count();
+
+    cout << runs << " runs of " << design.points() << " design points on "
+         << pool.workers() << " threads took " << elapsed << "sec" << endl;
+    return 0;
+}
@@ -0,0 +1,137 @@
+/** \brief This source file defines the compiler of timed event files.
+ *
+ * The text file is mapped and read line by line through log_view.
+ * Records are collected in a buffer and written with write(); the
+ * number of records is written to the header once all are known.
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "../lib/iestream.hpp"
+#include "../include/timed_events.hpp"
+#include "../include/log_view.hpp"
+
+#define EVENT_BUF_SIZE (1 << 20)
+
+using namespace std;
+
+/**
+ * Function that parses a time as "HH:MM:SS[:mmm[:...]]".
+ * @param text time text
+ * @param ticks time in milliseconds
+ * @return true if the time has at least one field
+*/
+static bool parse_ticks(string_view text, int64_t &ticks) {
+    int64_t fields[4] = {0, 0, 0, 0};
+    int field = 0;
+    bool digits = false;
+    for (char c : text) {
+        if (c == ':') {
+            if (++field == 4) {
+                break;
+            }
+        }
+        else if (c >= '0' && c <= '9') {
+            fields[field] = fields[field] * 10 + (c - '0');
+            digits = true;
+        }
+        else {
+            return false;
+        }
+    }
+    ticks = ((fields[0] * 60 + fields[1]) * 60 + fields[2]) * 1000
+            + fields[3];
+    return digits;
+}
+
+/**
+ * Function that writes the buffer to the file and clears it.
+*/
+static bool write_buffer(int fd, vector<char> &buf) {
+    size_t done = 0;
+    while (done < buf.size()) {
+        ssize_t size = write(fd, buf.data() + done, buf.size() - done);
+        if (size < 0) {
+            cout << "The timed event file can not be written, errno = "
+                 << errno << "\n";
+            return false;
+        }
+        done += size;
+    }
+    buf.clear();
+    return true;
+}
+
+int64_t compile_timed_events(char *fin, char *fout) {
+    mapped_file file(fin);
+    if (!file.is_open()) {
+        cout << "The file " << fin << " can not be opened for reading\n";
+        return -1;
+    }
+    int fd = open(fout, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        cout << "The file " << fout
+             << " can not be opened for writing, errno = " << errno << "\n";
+        return -1;
+    }
+
+    vector<char> buf;
+    buf.reserve(EVENT_BUF_SIZE + sizeof(timed_event_record));
+    buf.resize(sizeof(timed_event_record), '\0');
+    memcpy(buf.data(), TIMED_EVENT_MAGIC, 8);
+
+    int64_t events = 0;
+    uint64_t line_number = 0;
+    string value;
+    bool ok = true;
+    for (string_view line : log_view(file)) {
+        line_number++;
+        size_t t = line.find_first_not_of(" \t");
+        if (t == string_view::npos) {
+            continue;
+        }
+        size_t v = line.find_first_of(" \t", t);
+        size_t v_end = v == string_view::npos ? v : line.find_first_not_of(" \t", v);
+        timed_event_record record = {0, 0};
+        char *end = NULL;
+        if (v_end != string_view::npos) {
+            value.assign(line.substr(v_end));
+            record.value = strtoll(value.c_str(), &end, 10);
+        }
+        if (!parse_ticks(line.substr(t, v - t), record.ticks) ||
+            end == NULL || end == value.c_str() ||
+            strspn(end, " \t\r") != strlen(end) ||
+            record.value < 0 || record.value > UINT32_MAX) {
+            cout << "Line " << line_number << " of " << fin
+                 << " is not an event: " << line << "\n";
+            continue;
+        }
+        const char *bytes = reinterpret_cast<const char *>(&record);
+        buf.insert(buf.end(), bytes, bytes + sizeof(record));
+        events++;
+        if (buf.size() >= EVENT_BUF_SIZE && !(ok = write_buffer(fd, buf))) {
+            break;
+        }
+    }
+    if (ok) {
+        ok = write_buffer(fd, buf);
+    }
+
+    /**
+     * the number of records follows the magic number
+    */
+    uint64_t count = events;
+    if (ok && pwrite(fd, &count, sizeof(count), 8) != sizeof(count)) {
+        cout << "The timed event file can not be written, errno = "
+             << errno << "\n";
+    }
+    close(fd);
+    return events;
+}
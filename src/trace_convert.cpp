@@ -0,0 +1,29 @@
+/** \brief This file contains main function for the trace converter.
+ *
+ * The converter reads the binary trace written by the ABP_TRACE
+ * simulator and writes the text log and, optionally, the
+ * *_proc.txt table that output_file_process would produce.
+*/
+
+#include <iostream>
+
+#include "../include/trace_logger.hpp"
+
+using namespace std;
+
+int main(int argc, char ** argv) {
+
+    if (argc < 3) {
+        cout << "you are using this program with wrong parameters."
+            << "The program should be invoked as follows:";
+        cout << argv[0] << " path to the trace file"
+            << " path to the text log [path to the _proc file]" << endl;
+        return 1;
+    }
+
+    trace_to_text(argv[1], argv[2]);
+    if (argc > 3) {
+        trace_to_proc(argv[1], argv[3]);
+    }
+    return 0;
+}
@@ -0,0 +1,352 @@
+/** \brief This source file defines the binary event trace logger.
+ *
+ * Records are collected in a buffer and written to the trace
+ * file with write() once the buffer is full. The converters map
+ * the trace file and rebuild the formatted message lines, which
+ * are then written as they are or formatted by format_line.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "../include/trace_logger.hpp"
+#include "../include/file_process.hpp"
+
+#define TRACE_BUF_SIZE (1 << 20)
+
+using namespace std;
+
+/**
+ * separator between the port list and the name of model
+*/
+static const string_view MODEL_SEPARATOR = "] generated by model ";
+
+/**
+ * Function that builds the message of a value of a formatted line.
+ * Values up to UINT32_MAX are read as the input files are; larger
+ * ones can only be packets, written as packet * 10 + bit.
+*/
+static Message_t legacy_message(long long value) {
+    if (value <= UINT32_MAX) {
+        return Message_t((uint32_t) value);
+    }
+    return Message_t::data(value / 10, value % 10);
+}
+
+trace_writer::trace_writer(const char *path)
+    : _ticks(0), _step_written(false), _records(0) {
+    _fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (_fd < 0) {
+        cout << "The file " << path
+             << " can not be opened for writing, errno = " << errno << "\n";
+    }
+    _buf.reserve(TRACE_BUF_SIZE);
+    _buf.insert(_buf.end(), TRACE_MAGIC, TRACE_MAGIC + 8);
+    _buf.resize(sizeof(trace_record), '\0');
+}
+
+trace_writer::~trace_writer() {
+    close();
+}
+
+void trace_writer::time_line(string_view line) {
+    int64_t fields[4] = {0, 0, 0, 0};
+    int field = 0;
+    for (char c : line) {
+        if (c == ':') {
+            if (++field == 4) {
+                break;
+            }
+        }
+        else if (c >= '0' && c <= '9') {
+            fields[field] = fields[field] * 10 + (c - '0');
+        }
+    }
+    _ticks = ((fields[0] * 60 + fields[1]) * 60 + fields[2]) * 1000
+             + fields[3];
+    _step_written = false;
+}
+
+void trace_writer::message_line(string_view line) {
+    size_t q = line.rfind(MODEL_SEPARATOR);
+    if (line.empty() || line[0] != '[' || q == string_view::npos) {
+        return;
+    }
+    string_view model = line.substr(q + MODEL_SEPARATOR.size());
+    string_view body = line.substr(1, q - 1);
+    uint16_t model_id = 0;
+    bool model_known = false;
+
+    /**
+     * every item of the port list is "port: {value, value, ...}"
+    */
+    size_t pos = 0;
+    while (pos < body.size()) {
+        size_t j = body.find(": {", pos);
+        if (j == string_view::npos) {
+            break;
+        }
+        size_t k = body.find('}', j + 3);
+        if (k == string_view::npos) {
+            break;
+        }
+        string_view port = body.substr(pos, j - pos);
+        string_view values = body.substr(j + 3, k - j - 3);
+        if (!values.empty()) {
+            if (!model_known) {
+                model_id = intern(_models, model, TRACE_NAME_MODEL);
+                model_known = true;
+            }
+            uint16_t port_id = intern(_ports, port, TRACE_NAME_PORT);
+            start_step();
+            size_t v = 0;
+            while (v < values.size()) {
+                size_t comma = values.find(',', v);
+                if (comma == string_view::npos) {
+                    comma = values.size();
+                }
+                string value(values.substr(v, comma - v));
+                write_record(_ticks, model_id, port_id,
+                             legacy_message(strtoll(value.c_str(), NULL, 10)));
+                v = comma + 1;
+            }
+        }
+        pos = k + 1;
+        while (pos < body.size() && (body[pos] == ',' || body[pos] == ' ')) {
+            pos++;
+        }
+    }
+}
+
+void trace_writer::messages(string_view model, const message_bag_text &bag) {
+    if (bag.messages->empty()) {
+        return;
+    }
+    uint16_t model_id = intern(_models, model, TRACE_NAME_MODEL);
+    start_step();
+
+    /**
+     * the messages are written port by port, as the line lists them
+    */
+    for (size_t p = 0; p < bag.ports->size(); p++) {
+        uint16_t port_id = 0;
+        bool port_known = false;
+        for (const auto &m : *bag.messages) {
+            if (m.first != (int) p) {
+                continue;
+            }
+            if (!port_known) {
+                port_id = intern(_ports, (*bag.ports)[p], TRACE_NAME_PORT);
+                port_known = true;
+            }
+            write_record(_ticks, model_id, port_id, m.second);
+        }
+    }
+}
+
+uint16_t trace_writer::intern(unordered_map<string, uint16_t> &ids,
+                              string_view name, uint16_t marker) {
+    string key(name);
+    auto it = ids.find(key);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    uint16_t id = ids.size();
+    ids.emplace(key, id);
+
+    /**
+     * the name follows its record, padded to the record size
+    */
+    write_record((int64_t) name.size(), marker, id);
+    size_t padded = (name.size() + sizeof(trace_record) - 1)
+                    / sizeof(trace_record) * sizeof(trace_record);
+    _buf.insert(_buf.end(), name.begin(), name.end());
+    _buf.resize(_buf.size() + padded - name.size(), '\0');
+    return id;
+}
+
+void trace_writer::start_step() {
+    if (!_step_written) {
+        write_record(_ticks, TRACE_TIME, 0);
+        _step_written = true;
+    }
+}
+
+void trace_writer::write_record(int64_t ticks, uint16_t model, uint16_t port,
+                                const Message_t &message) {
+    trace_record record;
+    memset(&record, 0, sizeof(record));
+    record.ticks = ticks;
+    record.model = model;
+    record.port = port;
+    record.seq = message.seq;
+    record.session = message.session;
+    record.length = message.length;
+    record.kind = message.kind;
+    record.bit = message.bit;
+    const char *bytes = reinterpret_cast<const char *>(&record);
+    _buf.insert(_buf.end(), bytes, bytes + sizeof(record));
+    _records++;
+    if (_buf.size() >= TRACE_BUF_SIZE) {
+        flush();
+    }
+}
+
+void trace_writer::flush() {
+    size_t done = 0;
+    while (_fd >= 0 && done < _buf.size()) {
+        ssize_t size = write(_fd, _buf.data() + done, _buf.size() - done);
+        if (size < 0) {
+            cout << "The trace can not be written, errno = " << errno << "\n";
+            break;
+        }
+        done += size;
+    }
+    _buf.clear();
+}
+
+void trace_writer::close() {
+    if (_fd >= 0) {
+        flush();
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+/**
+ * Function that formats the time as "HH:MM:SS:mmm".
+*/
+static string format_ticks(int64_t ticks) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%02lld:%02lld:%02lld:%03lld",
+             (long long) (ticks / 3600000), (long long) (ticks / 60000 % 60),
+             (long long) (ticks / 1000 % 60), (long long) (ticks % 1000));
+    return buf;
+}
+
+/**
+ * Function that reads the trace and rebuilds its lines.
+ * on_time is called with the time of every simulation step and
+ * on_line with every message line, in the order they were logged.
+ * @return false if the file is not a trace
+*/
+template<typename ON_TIME, typename ON_LINE>
+static bool replay_trace(char *fin, ON_TIME on_time, ON_LINE on_line) {
+    mapped_file file(fin);
+    if (!file.is_open() || file.size() < sizeof(trace_record) ||
+        memcmp(file.data(), TRACE_MAGIC, 8) != 0) {
+        cout << "The file " << fin << " is not a trace\n";
+        return false;
+    }
+
+    vector<string> models;
+    vector<string> ports;
+    string line;
+    int line_model = -1;
+    int line_port = -1;
+    char value[32];
+
+    auto end_line = [&]() {
+        if (line_model >= 0) {
+            line += "}";
+            line += MODEL_SEPARATOR;
+            line += models[line_model];
+            on_line(line);
+            line.clear();
+            line_model = -1;
+            line_port = -1;
+        }
+    };
+
+    size_t pos = sizeof(trace_record);
+    while (pos + sizeof(trace_record) <= file.size()) {
+        trace_record record;
+        memcpy(&record, file.data() + pos, sizeof(record));
+        pos += sizeof(record);
+
+        if (record.model == TRACE_NAME_MODEL ||
+            record.model == TRACE_NAME_PORT) {
+            vector<string> &names =
+                record.model == TRACE_NAME_MODEL ? models : ports;
+            if (pos + record.ticks > file.size()) {
+                break;
+            }
+            names.resize(max<size_t>(names.size(), record.port + 1));
+            names[record.port].assign(file.data() + pos, record.ticks);
+            pos += (record.ticks + sizeof(trace_record) - 1)
+                   / sizeof(trace_record) * sizeof(trace_record);
+        }
+        else if (record.model == TRACE_TIME) {
+            end_line();
+            on_time(format_ticks(record.ticks));
+        }
+        else {
+            if (record.model != line_model) {
+                end_line();
+                line = "[";
+                line_model = record.model;
+            }
+            else if (record.port == line_port) {
+                line += ", ";
+            }
+            else {
+                line += "}, ";
+            }
+            if (record.port != line_port) {
+                line += ports[record.port];
+                line += ": {";
+                line_port = record.port;
+            }
+            Message_t message;
+            message.seq = record.seq;
+            message.session = record.session;
+            message.length = record.length;
+            message.kind = record.kind;
+            message.bit = record.bit;
+            snprintf(value, sizeof(value), "%lld",
+                     (long long) message.legacy_value());
+            line += value;
+        }
+    }
+    end_line();
+    return true;
+}
+
+void trace_to_text(char *fin, char *fout) {
+    ofstream out_file (fout);
+    if (!out_file.is_open()) {
+        cout << "The file " << fout
+             << " can not be opened for writing, errno = " << errno << "\n";
+        return;
+    }
+    replay_trace(fin,
+        [&](const string &time) { out_file << time << "\n"; },
+        [&](const string &line) { out_file << line << "\n"; });
+}
+
+void trace_to_proc(char *fin, char *fout) {
+    ofstream out_file (fout);
+    if (!out_file.is_open()) {
+        cout << "The file " << fout
+             << " can not be opened for writing, errno = " << errno << "\n";
+        return;
+    }
+    string time;
+    string out = "Time           Value  Port                Component\n";
+    replay_trace(fin,
+        [&](const string &t) { time = t; },
+        [&](const string &line) {
+            format_line(line.data(), line.size(), time, out);
+            if (out.size() >= TRACE_BUF_SIZE) {
+                out_file.write(out.data(), out.size());
+                out.clear();
+            }
+        });
+    out_file.write(out.data(), out.size());
+}
@@ -0,0 +1,212 @@
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <string>
+
+#include <cadmium/modeling/coupling.hpp>
+#include <cadmium/modeling/ports.hpp>
+#include <cadmium/modeling/dynamic_model_translator.hpp>
+#include <cadmium/concept/coupled_model_assert.hpp>
+#include <cadmium/modeling/dynamic_coupled.hpp>
+#include <cadmium/modeling/dynamic_atomic.hpp>
+#include <cadmium/engine/pdevs_dynamic_runner.hpp>
+#include <cadmium/logger/tuple_to_ostream.hpp>
+#include <cadmium/logger/common_loggers.hpp>
+
+
+#include "../../../lib/DESTimes/include/NDTime.hpp"
+#include "../../../include/tick_time.hpp"
+#include "../../../lib/iestream.hpp"
+
+#include "../../../include/message.hpp"
+
+#include "../../../include/file_process.hpp"
+#include "../../../include/filter_logger.hpp"
+#include "../../../include/buffered_repeater_cadmium.hpp"
+
+#define REPEATER_OUTPUTFILE_PATH "../test/data/buffered_repeater/buffered_repeater_test_output.txt"
+#define REPEATER_INPUTFILE_PATH "../test/data/buffered_repeater/buffered_repeater_input_test_packet_In.txt"
+#define REPEATER_ACKFILE_PATH "../test/data/buffered_repeater/buffered_repeater_input_test_ack_In.txt"
+#define REPEATER_MODIFIED_PATH "../test/data/buffered_repeater/buffered_repeater_test_proc.txt"
+using namespace std;
+
+using hclock = chrono::high_resolution_clock;
+#ifdef ABP_TICK_TIME
+using TIME = TickTime;
+#else
+using TIME = NDTime;
+#endif
+
+
+/***** SETING INPUT PORTS FOR COUPLEDs *****/
+struct inp_pack : public cadmium::in_port<Message_t> {};
+struct inp_ack : public cadmium::in_port<Message_t> {};
+
+/***** SETING OUTPUT PORTS FOR COUPLEDs *****/
+struct outp_ack : public cadmium::out_port<Message_t> {};
+struct outp_pack : public cadmium::out_port<Message_t> {};
+
+
+/********************************************/
+/****** APPLICATION GENERATOR *******************/
+/********************************************/
+template<typename T>
+class ApplicationGen : public iestream_input<Message_t,T> {
+    public:
+        ApplicationGen() = default;
+        ApplicationGen(const char* file_path) :
+            iestream_input<Message_t,T>(file_path) {
+    }
+};
+
+
+int main() {
+
+    auto start = hclock::now(); //to measure simulation execution time
+    char out_file[] = REPEATER_OUTPUTFILE_PATH;
+    char proc_file[] = REPEATER_MODIFIED_PATH;
+
+    /*************** Loggers *******************/
+    static std::ofstream out_data(
+        out_file);
+    struct oss_sink_provider {
+        static std::ostream& sink() {
+            return out_data;
+        }
+    };
+
+    using
+        info = cadmium::logger::logger<cadmium::logger::logger_info,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+    using
+        debug = cadmium::logger::logger<cadmium::logger::logger_debug,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+    using
+        state = cadmium::logger::logger<cadmium::logger::logger_state,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+    using
+        log_messages = cadmium::logger::logger<cadmium::logger::logger_messages,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+    using
+        routing = cadmium::logger::logger<cadmium::logger::logger_message_routing,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+    using
+        global_time = cadmium::logger::logger<cadmium::logger::logger_global_time,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+    using
+        local_time = cadmium::logger::logger<cadmium::logger::logger_local_time,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+    using
+        log_all = cadmium::logger::multilogger<info,
+            debug, state, log_messages, routing, global_time, local_time>;
+
+    using
+        log_nonempty_messages = nonempty_logger<cadmium::logger::logger_messages,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+
+    using logger_top = cadmium::logger::multilogger<log_nonempty_messages,
+        global_time>;
+
+
+    /*******************************************/
+
+
+
+    /********************************************/
+    /****** APPLICATION GENERATOR *******************/
+    /********************************************/
+    string input_data_pack = REPEATER_INPUTFILE_PATH;
+    const char* i_input_data_pack = input_data_pack.c_str();
+
+    std::shared_ptr<cadmium::dynamic::modeling::model>generator_pack =
+        cadmium::dynamic::translate::make_dynamic_atomic_model
+            <ApplicationGen, TIME, const char*>(
+                "generator_pack" , std::move(i_input_data_pack));
+
+    string input_data_ack = REPEATER_ACKFILE_PATH;
+    const char* i_input_data_ack = input_data_ack.c_str();
+
+    std::shared_ptr<cadmium::dynamic::modeling::model> generator_ack =
+        cadmium::dynamic::translate::make_dynamic_atomic_model
+            <ApplicationGen, TIME, const char*>(
+                "generator_ack" , std::move(i_input_data_ack));
+
+
+    /********************************************/
+    /****** BUFFERED REPEATER *******************/
+    /********************************************/
+
+    std::shared_ptr<cadmium::dynamic::modeling::model> repeater1 =
+        cadmium::dynamic::translate::make_dynamic_atomic_model
+            <BufferedRepeater, TIME, std::string, uint64_t,
+                repeater_buffer_config>("repeater1", std::string("repeater1"),
+                0, repeater_buffer_config());
+
+
+    /************************/
+    /*******TOP MODEL********/
+    /************************/
+    cadmium::dynamic::modeling::Ports iports_TOP = {};
+    cadmium::dynamic::modeling::Ports oports_TOP = {
+        typeid(outp_pack),typeid(outp_ack)
+    };
+    cadmium::dynamic::modeling::Models submodels_TOP = {
+        generator_pack, generator_ack, repeater1
+    };
+    cadmium::dynamic::modeling::EICs eics_TOP = {};
+    cadmium::dynamic::modeling::EOCs eocs_TOP = {
+        cadmium::dynamic::translate::make_EOC
+            <repeater_defs::packet_sent_out,outp_pack>("repeater1"),
+            cadmium::dynamic::translate::make_EOC
+                <repeater_defs::ack_received_out,outp_ack>("repeater1")
+    };
+    cadmium::dynamic::modeling::ICs ics_TOP = {
+        cadmium::dynamic::translate::make_IC
+            <iestream_input_defs<Message_t>::out,
+                repeater_defs::packet_in>("generator_pack","repeater1"),
+            cadmium::dynamic::translate::make_IC
+                <iestream_input_defs<Message_t>::out,
+                    repeater_defs::ack_in>("generator_ack","repeater1")
+    };
+    std::shared_ptr<cadmium::dynamic::modeling::coupled<TIME>> TOP =
+        std::make_shared<cadmium::dynamic::modeling::coupled<TIME>>(
+                                                                    "TOP",
+                                                                    submodels_TOP,
+                                                                    iports_TOP,
+                                                                    oports_TOP,
+                                                                    eics_TOP,
+                                                                    eocs_TOP,
+                                                                    ics_TOP);
+
+    ///****************////
+
+    auto elapsed1 = std::chrono::duration_cast<std::chrono::duration
+        <double,std::ratio<1>>> (hclock::now() - start).count();
+    cout<<"Model Created. Elapsed time: "<<elapsed1<<"sec"<<endl;
+    
+    cadmium::dynamic::engine::runner<TIME, logger_top> r(TOP, {0});
+    elapsed1 = std::chrono::duration_cast<std::chrono::duration
+        <double, std::ratio<1>>> (hclock::now() - start).count();
+    cout<<"Runner Created. Elapsed time: "<<elapsed1<<"sec"<<endl;
+
+    cout<<"Simulation starts"<<endl;
+
+    r.run_until(TIME("04:00:00:000"));
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration
+        <double, std::ratio<1>>> (hclock::now() - start).count();
+    cout<<"Simulation took:"<<elapsed<<"sec"<<endl;
+    cout<<"Empty message bags not logged: "
+        <<log_nonempty_messages::suppressed()<<endl;
+
+    output_file_process(out_file, proc_file);
+
+    return 0;
+}
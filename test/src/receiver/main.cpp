@@ -27,11 +27,13 @@
 
 
 #include "../../../lib/DESTimes/include/NDTime.hpp"
+#include "../../../include/tick_time.hpp"
 #include "../../../lib/iestream.hpp"
 
 #include "../../../include/message.hpp"
 
 #include "../../../include/file_process.hpp"
+#include "../../../include/filter_logger.hpp"
 #include "../../../include/receiver_cadmium.hpp"
 
 #define RECEIVER_OUTPUTFILE_PATH "../test/data/receiver/receiver_test_output.txt"
@@ -40,7 +42,11 @@
 using namespace std;
 
 using hclock = chrono::high_resolution_clock;
+#ifdef ABP_TICK_TIME
+using TIME = TickTime;
+#else
 using TIME = NDTime;
+#endif
 
 
 /**
@@ -128,7 +134,13 @@ int main() {
         log_all = cadmium::logger::multilogger <info,
             debug, state, log_messages, routing, global_time, local_time>;
 
-    using logger_top = cadmium::logger::multilogger<log_messages, global_time>;
+    using
+        log_nonempty_messages = nonempty_logger<cadmium::logger::logger_messages,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+
+    using logger_top = cadmium::logger::multilogger<log_nonempty_messages,
+        global_time>;
 
 
 
@@ -201,17 +213,19 @@ int main() {
         <double,std::ratio<1>>> (hclock::now() - start).count();
     cout<<"Model Created. Elapsed time: "<<elapsed1<<"sec"<<endl;
 
-    cadmium::dynamic::engine::runner<NDTime, logger_top> r(TOP, {0});
+    cadmium::dynamic::engine::runner<TIME, logger_top> r(TOP, {0});
     elapsed1 = std::chrono::duration_cast<std::chrono::duration
         <double,std::ratio<1>>> (hclock::now() - start).count();
     cout<<"Runner Created. Elapsed time: "<<elapsed1<<"sec"<<endl;
 
     cout<<"Simulation starts"<<endl;
 
-    r.run_until(NDTime("04:00:00:000"));
+    r.run_until(TIME("04:00:00:000"));
     auto elapsed = std::chrono::duration_cast<std::chrono::duration
         <double, std::ratio<1>>> (hclock::now() - start).count();
     cout<<"Simulation took:"<<elapsed<<"sec"<<endl;
+    cout<<"Empty message bags not logged: "
+        <<log_nonempty_messages::suppressed()<<endl;
 
     output_file_process(out_file, proc_file);
 
@@ -15,10 +15,12 @@
 
 
 #include "../../../lib/DESTimes/include/NDTime.hpp"
+#include "../../../include/tick_time.hpp"
 #include "../../../lib/iestream.hpp"
 
 #include "../../../include/message.hpp"
 #include "../../../include/file_process.hpp"
+#include "../../../include/filter_logger.hpp"
 
 #include "../../../include/subnet_cadmium.hpp"
 
@@ -28,7 +30,11 @@
 using namespace std;
 
 using hclock = chrono::high_resolution_clock;
+#ifdef ABP_TICK_TIME
+using TIME = TickTime;
+#else
 using TIME = NDTime;
+#endif
 
 
 /***** SETING INPUT PORTS FOR COUPLEDs *****/
@@ -98,7 +104,13 @@ int main() {
         log_all = cadmium::logger::multilogger<info,
             debug, state, log_messages, routing, global_time, local_time>;
 
-    using logger_top = cadmium::logger::multilogger<log_messages, global_time>;
+    using
+        log_nonempty_messages = nonempty_logger<cadmium::logger::logger_messages,
+            cadmium::dynamic::logger::formatter<TIME>,
+                oss_sink_provider>;
+
+    using logger_top = cadmium::logger::multilogger<log_nonempty_messages,
+        global_time>;
 
 
     /*******************************************/
@@ -123,7 +135,8 @@ int main() {
 
     std::shared_ptr<cadmium::dynamic::modeling::model> subnet1 =
         cadmium::dynamic::translate::make_dynamic_atomic_model
-            <Subnet, TIME>("subnet1");
+            <Subnet, TIME, std::string, uint64_t>("subnet1",
+                std::string("subnet1"), 0);
 
 
     /************************/
@@ -161,17 +174,19 @@ int main() {
         <double, std::ratio<1>>>(hclock::now() - start).count();
     cout<<"Model Created. Elapsed time: "<<elapsed1<<"sec"<<endl;
     
-    cadmium::dynamic::engine::runner<NDTime, logger_top> r(TOP, {0});
+    cadmium::dynamic::engine::runner<TIME, logger_top> r(TOP, {0});
     elapsed1 = std::chrono::duration_cast<std::chrono::duration
         <double, std::ratio<1>>> (hclock::now() - start).count();
     cout<<"Runner Created. Elapsed time: "<<elapsed1<<"sec"<<endl;
 
     cout<<"Simulation starts"<<endl;
 
-    r.run_until(NDTime("04:00:00:000"));
+    r.run_until(TIME("04:00:00:000"));
     auto elapsed = std::chrono::duration_cast<std::chrono::duration
         <double, std::ratio<1>>> (hclock::now() - start).count();
     cout<<"Simulation took:"<<elapsed<<"sec"<<endl;
+    cout<<"Empty message bags not logged: "
+        <<log_nonempty_messages::suppressed()<<endl;
 
     output_file_process(out_file, proc_file);
 